@@ -0,0 +1,892 @@
+/*******************************************************************************************
+*
+* Nostalgia Simulator - Headless Benchmarks
+*
+* Micro-benchmarks for the raylib-free parts of the game. No window, no audio, no raylib.
+*
+* -- BUILD --
+*   g++ -O2 -std=c++17 bench.cpp pacman_core.cpp pacman_batch.cpp pacman_replay.cpp pacman_autopilot.cpp level_file.cpp pong_chaos.cpp -o bench -pthread
+*
+* -- RUN --
+*   ./bench          Run every benchmark
+*   ./bench bfs      Run only the named benchmark (bfs, apsp, core, batch, parity, level,
+*                    swarm, snapshot, zobrist, replay, autopilot, pong, chaos)
+*   ./bench replay replays/last_session.nsrp
+*                    Replay a recorded session as a regression check and timing workload
+*
+********************************************************************************************/
+#include "maze.h"
+#include "pacman_core.h"
+#include "pacman_batch.h"
+#include "pacman_replay.h"
+#include "pacman_autopilot.h"
+#include "embedded_levels.h"
+#include "pong_physics.h"
+#include "pong_chaos.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using BenchClock = std::chrono::steady_clock;
+
+static double SecondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+// Picks 'count' random open tiles to use as sources.
+static std::vector<std::pair<int, int>> RandomOpenTiles(const TileGrid& grid, int count, unsigned seed) {
+    std::vector<std::pair<int, int>> open;
+    for (int y = 0; y < grid.height; y++)
+        for (int x = 0; x < grid.width; x++)
+            if (!grid.IsWall(x, y)) open.push_back({x, y});
+
+    std::mt19937 rng(seed);
+    std::vector<std::pair<int, int>> picked;
+    for (int i = 0; i < count && !open.empty(); i++) picked.push_back(open[rng() % open.size()]);
+    return picked;
+}
+
+// ---------- BFS distance field ----------
+// The per-frame BFS the game used before TileDistanceTable, against the table on the same
+// maps: the cost of a new target (a BFS rebuild, or at most a lazy row fill) and of the
+// per-ghost downhill step toward it.
+static void BenchDistanceField(const char* label, const std::vector<std::string>& lines, int iterations) {
+    TileGrid grid;
+    grid.Build(lines);
+
+    DistanceField field;
+    auto sources = RandomOpenTiles(grid, iterations, 1234);
+
+    auto start = BenchClock::now();
+    for (const auto& s : sources) {
+        field.Invalidate();
+        field.Build(grid, s.first, s.second);
+    }
+    double rebuildUs = SecondsSince(start) * 1e6 / sources.size();
+
+    TileDistanceTable table;
+    table.Build(grid);
+    auto ghosts = RandomOpenTiles(grid, 4096, 99);
+    volatile uint32_t sink = 0;
+    start = BenchClock::now();
+    for (const auto& s : sources) sink = sink + table.Distance(grid, ghosts[0].first, ghosts[0].second, s.first, s.second);
+    double retargetUs = SecondsSince(start) * 1e6 / sources.size();
+
+    // Downhill step for a crowd of ghosts toward the last source
+    const auto& target = sources.back();
+    const int lookupRounds = 256;
+    start = BenchClock::now();
+    for (int r = 0; r < lookupRounds; r++) {
+        for (const auto& g : ghosts) {
+            uint32_t best = DistanceField::UNREACHABLE;
+            best = std::min(best, field.At(g.first, g.second - 1, grid));
+            best = std::min(best, field.At(g.first, g.second + 1, grid));
+            best = std::min(best, field.At(g.first - 1, g.second, grid));
+            best = std::min(best, field.At(g.first + 1, g.second, grid));
+            sink = sink + best;
+        }
+    }
+    double lookupNs = SecondsSince(start) * 1e9 / (lookupRounds * ghosts.size());
+
+    start = BenchClock::now();
+    for (int r = 0; r < lookupRounds; r++) {
+        for (const auto& g : ghosts) {
+            uint32_t best = TileDistanceTable::UNREACHABLE;
+            best = std::min<uint32_t>(best, table.Distance(grid, g.first, g.second - 1, target.first, target.second));
+            best = std::min<uint32_t>(best, table.Distance(grid, g.first, g.second + 1, target.first, target.second));
+            best = std::min<uint32_t>(best, table.Distance(grid, g.first - 1, g.second, target.first, target.second));
+            best = std::min<uint32_t>(best, table.Distance(grid, g.first + 1, g.second, target.first, target.second));
+            sink = sink + best;
+        }
+    }
+    double tableLookupNs = SecondsSince(start) * 1e9 / (lookupRounds * ghosts.size());
+
+    printf("  %-12s %5dx%-5d  new target: bfs %9.2f us  table %7.2f us   ghost step: bfs %5.2f ns  table %5.2f ns  (%s)\n",
+           label, grid.width, grid.height, rebuildUs, retargetUs, lookupNs, tableLookupNs, table.IsLazy() ? "lazy" : "full");
+}
+
+static void RunBfsBenchmarks() {
+    printf("bfs: per-target BFS distance field against TileDistanceTable\n");
+
+    std::vector<std::string> classic;
+    if (LoadLevelLines("level.txt", classic)) BenchDistanceField("level.txt", classic, 20000);
+    else printf("  level.txt not found, skipping classic maze\n");
+
+    BenchDistanceField("generated", GenerateMazeLines(200, 200, 1), 500);
+    BenchDistanceField("generated", GenerateMazeLines(1000, 1000, 1), 20);
+}
+
+// ---------- All-pairs distance table ----------
+// Build time and memory at LoadMap, plus the cost of a targeting lookup.
+static void BenchDistanceTable(const char* label, const std::vector<std::string>& lines) {
+    TileGrid grid;
+    grid.Build(lines);
+
+    TileDistanceTable table;
+    table.Build(grid);
+
+    auto from = RandomOpenTiles(grid, 4096, 7);
+    auto to = RandomOpenTiles(grid, 64, 8); // a handful of targets, like ghosts chasing the player
+    volatile uint32_t sink = 0;
+    const int rounds = 64;
+    auto start = BenchClock::now();
+    for (int r = 0; r < rounds; r++) {
+        const auto& target = to[r % to.size()];
+        for (const auto& f : from) sink = sink + table.Distance(grid, f.first, f.second, target.first, target.second);
+    }
+    double lookupNs = SecondsSince(start) * 1e9 / (rounds * from.size());
+
+    printf("  %-12s %5dx%-5d  %6d open  %-5s  build %9.2f ms  %9.1f KB  lookup %6.2f ns  row misses %d\n",
+           label, grid.width, grid.height, table.openCount, table.IsLazy() ? "lazy" : "full",
+           table.buildMs, table.MemoryBytes() / 1024.0, lookupNs, table.rowMisses);
+}
+
+static void RunApspBenchmarks() {
+    printf("apsp: all-pairs tile distance table\n");
+
+    std::vector<std::string> classic;
+    if (LoadLevelLines("level.txt", classic)) BenchDistanceTable("level.txt", classic);
+    else printf("  level.txt not found, skipping classic maze\n");
+
+    BenchDistanceTable("generated", GenerateMazeLines(64, 64, 1));
+    BenchDistanceTable("generated", GenerateMazeLines(200, 200, 1));
+}
+
+// ---------- Headless core ----------
+// Single-thread Step() throughput with a random-walk bot, resetting whenever a game ends.
+static void BenchCoreLevel(const char* label, PacmanCore& game, long steps) {
+    game.Reset();
+    std::mt19937 rng(42);
+    PacAction action = ACTION_LEFT;
+    long games = 0, totalScore = 0;
+
+    auto start = BenchClock::now();
+    for (long i = 0; i < steps; i++) {
+        if ((i & 15) == 0) action = (PacAction)(1 + rng() % 4);
+        if (game.Step(action).done) {
+            games++;
+            totalScore += game.GetScore();
+            game.Reset();
+        }
+    }
+    double seconds = SecondsSince(start);
+
+    printf("  %-12s %5dx%-5d  %10.0f steps/s  %7.3f us/step  %ld games (avg score %ld)\n",
+           label, game.GetMapWidth(), game.GetMapHeight(), steps / seconds, seconds * 1e6 / steps,
+           games, games ? totalScore / games : 0);
+}
+
+static void RunCoreBenchmarks() {
+    printf("core: headless PacmanCore::Step on one core\n");
+
+    PacmanCore game;
+    if (game.LoadLevel("level.txt")) BenchCoreLevel("level.txt", game, 2000000);
+    else printf("  level.txt not found, skipping classic maze\n");
+
+    if (game.LoadLevelFromLines(GenerateMazeLines(64, 64, 1))) BenchCoreLevel("generated", game, 500000);
+    if (game.LoadLevelFromLines(GenerateMazeLines(1000, 1000, 1))) BenchCoreLevel("generated", game, 500000);
+}
+
+// ---------- Batch environment ----------
+// Total game steps per second for N games stepped together across every core.
+static void BenchBatch(const PacmanCore& level, int gameCount, int threads, int steps) {
+    PacmanBatch batch;
+    if (!batch.Init(level, gameCount, threads)) {
+        printf("  batch init failed (map too large for a full distance table?)\n");
+        return;
+    }
+
+    std::vector<uint8_t> actions(gameCount, ACTION_LEFT);
+    std::mt19937 rng(42);
+    long finished = 0;
+
+    auto start = BenchClock::now();
+    for (int s = 0; s < steps; s++) {
+        if ((s & 15) == 0) for (auto& a : actions) a = (uint8_t)(1 + rng() % 4);
+        batch.Step(actions.data());
+    }
+    double seconds = SecondsSince(start);
+    for (int i = 0; i < gameCount; i++) finished += (long)batch.gamesFinished[i];
+
+    printf("  %6d games  %2d threads  %12.0f game steps/s  %ld games finished\n",
+           gameCount, batch.GetThreadCount(), (double)gameCount * steps / seconds, finished);
+}
+
+static void RunBatchBenchmarks() {
+    printf("batch: PacmanBatch structure-of-arrays stepping\n");
+
+    PacmanCore level;
+    if (!level.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+    int hardwareThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+    BenchBatch(level, 4096, 1, 500);
+    if (hardwareThreads > 1) BenchBatch(level, 4096, hardwareThreads, 500);
+    BenchBatch(level, 65536, hardwareThreads, 50);
+}
+
+// ---------- Core/batch parity ----------
+// PacmanBatch keeps its games in arrays of its own, so it steps them with its own loops
+// around the shared PacmanCore rules. Plays the same seeded random inputs through both and
+// compares every field of every game after every tick; any difference is a mismatch.
+static long CountBatchMismatches(const PacmanBatch& batch, int game, const PacmanCore& core, const PacStepResult& result) {
+    long mismatches = 0;
+    auto check = [&](bool same) { if (!same) mismatches++; };
+
+    const PacmanCore::Player& player = core.GetPlayer();
+    check(batch.playerX[game] == player.position.x && batch.playerY[game] == player.position.y);
+    check(batch.playerDirX[game] == player.direction.x && batch.playerDirY[game] == player.direction.y);
+    check(batch.desiredDirX[game] == player.desiredDirection.x && batch.desiredDirY[game] == player.desiredDirection.y);
+    check(batch.score[game] == core.GetScore() && batch.lives[game] == core.GetLives());
+    check(batch.activePellets[game] == core.GetActivePellets());
+    check(batch.roundState[game] == core.GetRoundState() && batch.roundTimer[game] == core.GetRoundStateTicks());
+    check(batch.rewards[game] == result.reward && (batch.dones[game] != 0) == result.done);
+
+    const PacmanCore::GhostArrays& ghosts = core.GetGhosts();
+    for (int g = 0; g < batch.GetGhostsPerGame(); g++) {
+        size_t i = (size_t)game * batch.GetGhostsPerGame() + g;
+        check(batch.ghostX[i] == ghosts.position[g].x && batch.ghostY[i] == ghosts.position[g].y);
+        check(batch.ghostDirX[i] == ghosts.direction[g].x && batch.ghostDirY[i] == ghosts.direction[g].y);
+        check(batch.ghostState[i] == ghosts.state[g] && batch.ghostSpeed[i] == ghosts.speed[g]);
+        if (ghosts.state[g] == PacmanCore::FRIGHTENED) check(batch.ghostTimer[i] == ghosts.stateTicks[g]);
+    }
+    for (int p = 0; p < batch.GetPelletsPerGame(); p++) check(batch.IsPelletActive(game, p) == core.IsPelletActive(p));
+    return mismatches;
+}
+
+static void CheckBatchParity(const char* label, const PacmanCore& level, int gameCount, int ticks) {
+    PacmanBatch batch;
+    if (!batch.Init(level, gameCount, 2)) {
+        printf("  %-16s batch init failed\n", label);
+        return;
+    }
+    std::vector<PacmanCore> cores(gameCount, level);
+    for (PacmanCore& core : cores) core.Reset();
+
+    std::mt19937 rng(30);
+    std::vector<uint8_t> actions(gameCount, ACTION_NONE);
+    long mismatches = 0, finished = 0;
+    int firstBadTick = -1;
+    for (int tick = 0; tick < ticks; tick++) {
+        for (uint8_t& action : actions) {
+            if (rng() % 12 == 0) action = (uint8_t)(rng() % ACTION_COUNT);
+        }
+        batch.Step(actions.data());
+        for (int game = 0; game < gameCount; game++) {
+            PacStepResult result = cores[game].Step((PacAction)actions[game]);
+            if (result.done) {
+                cores[game].Reset(); // The batch resets a finished game in the same step
+                finished++;
+            }
+            long bad = CountBatchMismatches(batch, game, cores[game], result);
+            if (bad > 0 && firstBadTick < 0) firstBadTick = tick;
+            mismatches += bad;
+        }
+    }
+    printf("  %-16s %3d games x %6d ticks  %5ld games finished  %ld mismatches", label, gameCount, ticks, finished, mismatches);
+    if (firstBadTick >= 0) printf(" (first at tick %d)", firstBadTick);
+    printf("\n");
+}
+
+static void RunParityBenchmarks() {
+    printf("parity: PacmanBatch against PacmanCore, tick by tick\n");
+
+    PacmanCore level;
+    if (level.LoadLevel("level.txt")) {
+        CheckBatchParity("level.txt", level, 16, 100000);
+        PacmanCore::Speeds fast;
+        fast.player = 72;
+        fast.ghost = 60;
+        fast.frightened = 36;
+        fast.frightenedTicks = 200;
+        level.SetSpeeds(fast);
+        level.Reset();
+        CheckBatchParity("level.txt, fast", level, 16, 100000);
+    } else {
+        printf("  level.txt not found, skipping classic maze\n");
+    }
+    PacmanCore generated;
+    if (generated.LoadLevelFromLines(GenerateMazeLines(41, 41, 3))) CheckBatchParity("generated 41x41", generated, 16, 100000);
+}
+
+// ---------- Ghost swarm ----------
+// Simulation share of the frame time for a growing swarm. Only ticks that start in PLAYING
+// count: a big swarm kills the player at once, and dying/ready ticks don't move the ghosts.
+// A swarm touching the player at once must still cost one life, never going below zero.
+static void BenchSwarm(PacmanCore& game, int ghostCount, int playingTicks) {
+    game.SpawnGhostSwarm(ghostCount, 7);
+    game.Reset();
+
+    double seconds = 0.0;
+    int measured = 0, deaths = 0, badLifeTicks = 0;
+    for (int i = 0; measured < playingTicks; i++) {
+        bool playing = game.GetRoundState() == PacmanCore::PLAYING;
+        int livesBefore = game.GetLives();
+        auto start = BenchClock::now();
+        PacStepResult result = game.Step((PacAction)(1 + (i / 16) % 4));
+        if (playing) {
+            seconds += SecondsSince(start);
+            measured++;
+        }
+        if (livesBefore - game.GetLives() > 1 || game.GetLives() < 0) badLifeTicks++;
+        if (result.events & EVENT_PLAYER_DIED) deaths++;
+        if (result.done) game.Reset();
+    }
+    double tickUs = seconds * 1e6 / measured;
+    printf("  %6d ghosts  %9.1f us/tick  %5.2f%% of a 60 Hz frame  (%d deaths, %d bad life ticks)\n",
+           ghostCount, tickUs, tickUs / (1e6 / 60.0) * 100.0, deaths, badLifeTicks);
+}
+
+static void RunSwarmBenchmarks() {
+    printf("swarm: PacmanCore::Step against ghost count\n");
+
+    PacmanCore game;
+    if (!game.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+    for (int count : { 4, 256, 1000, 4000, 16000 }) BenchSwarm(game, count, 2000);
+
+    if (game.LoadLevelFromLines(GenerateMazeLines(200, 200, 3))) {
+        printf("  200x200 generated maze:\n");
+        for (int count : { 4, 1000, 16000 }) BenchSwarm(game, count, 2000);
+    }
+}
+
+// ---------- Snapshots ----------
+// Save/restore cost of the whole game state, plus a replay check: restoring and stepping the
+// same actions again must land on exactly the same state.
+static void RunSnapshotBenchmarks() {
+    printf("snapshot: PacmanCore::SaveSnapshot / RestoreSnapshot\n");
+
+    PacmanCore game;
+    if (!game.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+    game.Reset();
+    std::mt19937 rng(3);
+    for (int i = 0; i < 600; i++) game.Step((PacAction)(1 + rng() % 4));
+
+    PacmanCore::Snapshot snapshot{}, after{};  // Zeroed so the memcmp below skips unused slots
+    const int iterations = 5000000;
+    long sink = 0;
+
+    auto start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) {
+        game.SaveSnapshot(snapshot);
+        sink += snapshot.score;
+    }
+    double saveNs = SecondsSince(start) * 1e9 / iterations;
+
+    start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) {
+        game.RestoreSnapshot(snapshot);
+        sink += game.GetScore();
+    }
+    double restoreNs = SecondsSince(start) * 1e9 / iterations;
+
+    std::vector<PacAction> actions(300);
+    for (auto& a : actions) a = (PacAction)(1 + rng() % 4);
+    for (PacAction a : actions) game.Step(a);
+    game.SaveSnapshot(after);
+    game.RestoreSnapshot(snapshot);
+    for (PacAction a : actions) game.Step(a);
+    PacmanCore::Snapshot replayed{};
+    game.SaveSnapshot(replayed);
+    bool same = replayed.score == after.score && replayed.player.position.x == after.player.position.x &&
+                replayed.player.position.y == after.player.position.y &&
+                memcmp(replayed.ghostPosition, after.ghostPosition, sizeof(after.ghostPosition)) == 0 &&
+                memcmp(replayed.pelletBits, after.pelletBits, sizeof(after.pelletBits)) == 0;
+
+    // Same ghost and pellet counts, different level hash: must be refused
+    PacmanCore other = game;
+    PacmanCore::Speeds otherSpeeds = other.GetSpeeds();
+    otherSpeeds.ghost++;
+    other.SetSpeeds(otherSpeeds);
+    bool refused = !other.RestoreSnapshot(snapshot);
+
+    printf("  %zu bytes   save %6.1f ns   restore %6.1f ns   replay after restore %s   other level %s  (%ld)\n",
+           sizeof(PacmanCore::Snapshot), saveNs, restoreNs, same ? "matches" : "DIFFERS", refused ? "refused" : "RESTORED", sink % 10);
+}
+
+// ---------- Zobrist hashing ----------
+// The incremental hash must always equal a from-scratch recompute, and keeping it up to date
+// must cost Step() far less than that recompute.
+static void RunZobristBenchmarks() {
+    printf("zobrist: incremental PacmanCore state hash\n");
+
+    PacmanCore game;
+    if (!game.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+
+    std::mt19937 rng(8);
+    long ticks = 0, mismatches = 0;
+    double computeSeconds = 0.0;
+    volatile uint64_t sink = 0;
+    for (int g = 0; g < 100; g++) {
+        game.Reset();
+        PacAction action = ACTION_LEFT;
+        for (int i = 0; i < 20000; i++) {
+            if (rng() % 12 == 0) action = (PacAction)(rng() % 5);
+            bool done = game.Step(action).done;
+            ticks++;
+            auto start = BenchClock::now();
+            uint64_t full = game.ComputeZobristHash();
+            computeSeconds += SecondsSince(start);
+            if (full != game.GetZobristHash()) mismatches++;
+            sink = sink + full;
+            if (done) break;
+        }
+    }
+
+    // Incremental upkeep: the same seeded games with the hash on and off, Step() time only
+    double stepSeconds[2] = {};
+    long stepTicks = 0;
+    const int passes = 10;
+    for (int pass = 0; pass < passes; pass++) {
+        bool enabled = pass % 2 == 0;
+        game.SetZobristEnabled(enabled);
+        std::mt19937 stepRng(9);
+        for (int g = 0; g < 100; g++) {
+            game.Reset();
+            PacAction action = ACTION_LEFT;
+            auto start = BenchClock::now();
+            for (int i = 0; i < 20000; i++) {
+                if (stepRng() % 12 == 0) action = (PacAction)(stepRng() % 5);
+                stepTicks++;
+                if (game.Step(action).done) break;
+            }
+            stepSeconds[enabled ? 0 : 1] += SecondsSince(start);
+            sink = sink + game.GetZobristHash();
+        }
+    }
+    game.SetZobristEnabled(true);
+    double incrementalNs = (stepSeconds[0] - stepSeconds[1]) * 1e9 / (stepTicks / 2.0);
+
+    printf("  %ld ticks checked, %ld mismatches; full recompute %.1f ns vs. incremental %.1f ns (Step with hash minus without)\n",
+           ticks, mismatches, computeSeconds * 1e9 / ticks, incrementalNs);
+}
+
+// ---------- Replays ----------
+// Plays a recording back and checks every keyframe, and the final state, against the
+// original session. Without a file, records a bot session on level.txt first.
+static void RunReplayBenchmarks(const char* replayFile) {
+    printf("replay: PacmanRecording playback and seek\n");
+
+    PacmanCore game;
+    if (!game.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+
+    PacmanRecording recording;
+    uint64_t finalHash = 0;
+    bool knowFinal = false;
+    if (replayFile) {
+        if (!recording.Load(replayFile)) {
+            printf("  could not load %s\n", replayFile);
+            return;
+        }
+    } else {
+        // A bot that holds each direction for a while, like a player would. Keeps the longest
+        // of a few sessions so playback has something to chew on.
+        for (unsigned seed = 1; seed <= 64; seed++) {
+            PacmanRecording attempt;
+            game.Reset();
+            attempt.Begin(game);
+            std::mt19937 rng(seed);
+            PacAction action = ACTION_LEFT;
+            int hold = 0;
+            for (int tick = 0; tick < 20 * 60 * 60; tick++) {
+                if (--hold <= 0) {
+                    action = (PacAction)(rng() % 5);
+                    hold = 5 + rng() % 40;
+                }
+                attempt.Record(game, action);
+                if (game.Step(action).done) break;
+            }
+            if (attempt.GetTickCount() > recording.GetTickCount()) {
+                attempt.Finish();
+                recording = std::move(attempt);
+                finalHash = PacmanRecording::StateHash(game);
+            }
+        }
+        knowFinal = true;
+
+        const char* fileName = "bench_replay.nsrp";
+        bool saved = recording.Save(fileName);
+        PacmanRecording loaded;
+        if (!saved || !loaded.Load(fileName)) {
+            printf("  save/load round trip failed\n");
+            return;
+        }
+        recording = std::move(loaded);
+
+        // Keyframe records sit at the end of the file; move keyframe 1 off its tick and
+        // Load() must refuse the file, since Seek() trusts the keyframe spacing
+        bool badKeyframeRefused = false;
+        FILE* file = fopen(fileName, "r+b");
+        if (file && recording.GetKeyframeCount() > 1) {
+            long record = (long)(2 * sizeof(int32_t) + sizeof(uint64_t) + sizeof(PacmanCore::Snapshot));
+            int32_t tick = 0;
+            fseek(file, -(recording.GetKeyframeCount() - 1) * record, SEEK_END);
+            long at = ftell(file);
+            if (fread(&tick, sizeof(tick), 1, file) == 1) {
+                tick++;
+                fseek(file, at, SEEK_SET);
+                fwrite(&tick, sizeof(tick), 1, file);
+            }
+        }
+        if (file) {
+            fclose(file);
+            PacmanRecording corrupt;
+            badKeyframeRefused = !corrupt.Load(fileName);
+        }
+        printf("  save/load round trip ok, misplaced keyframe %s\n", badKeyframeRefused ? "refused" : "ACCEPTED");
+        remove(fileName);
+    }
+    if (recording.GetLevelHash() != game.GetLevelHash()) {
+        printf("  recording was made on a different level\n");
+        return;
+    }
+
+    int ticks = recording.GetTickCount();
+    printf("  %d ticks (%.1f min), %zu input bytes (%.2f bytes/s of play), %d keyframes\n",
+           ticks, ticks / 3600.0, recording.GetInputBytes(), recording.GetInputBytes() * 60.0 / std::max(ticks, 1),
+           recording.GetKeyframeCount());
+
+    // Bit-exact check: every keyframe of the file must be reproduced by playing the inputs
+    PacmanRecording::Cursor cursor;
+    recording.Seek(game, 0, cursor);
+    int mismatches = 0, nextKeyframe = 1;
+    while (cursor.tick < ticks) {
+        game.Step(recording.Next(cursor));
+        if (nextKeyframe < recording.GetKeyframeCount() && recording.GetKeyframeTick(nextKeyframe) == cursor.tick) {
+            if (PacmanRecording::StateHash(game) != recording.GetKeyframeHash(nextKeyframe)) mismatches++;
+            nextKeyframe++;
+        }
+    }
+    if (knowFinal && PacmanRecording::StateHash(game) != finalHash) mismatches++;
+    printf("  playback %s (%d of %d keyframes checked%s)\n", mismatches == 0 ? "matches" : "DIFFERS",
+           nextKeyframe - 1, recording.GetKeyframeCount() - 1, knowFinal ? ", plus the final state" : "");
+
+    const int rounds = 20;
+    auto start = BenchClock::now();
+    for (int r = 0; r < rounds; r++) {
+        recording.Seek(game, 0, cursor);
+        while (cursor.tick < ticks) game.Step(recording.Next(cursor));
+    }
+    double seconds = SecondsSince(start);
+    printf("  full playback  %10.0f ticks/s  %7.3f us/tick  (%.0fx real time)\n",
+           (double)rounds * ticks / seconds, seconds * 1e6 / ((double)rounds * ticks), rounds * ticks / 60.0 / seconds);
+
+    std::mt19937 rng(5);
+    const int seeks = 2000;
+    start = BenchClock::now();
+    for (int i = 0; i < seeks; i++) recording.Seek(game, (int)(rng() % (ticks + 1)), cursor);
+    double seekUs = SecondsSince(start) * 1e6 / seeks;
+    printf("  random seek    %9.1f us  (at most %d ticks from a keyframe)\n", seekUs, PacmanRecording::KEYFRAME_INTERVAL - 1);
+}
+
+// ---------- Autopilot ----------
+// Plays one game with the MCTS autopilot as the channel would, one tick per simulated frame,
+// with a fixed search budget per frame. Rollouts/s is also a stress figure for Step() and
+// RestoreSnapshot() under every core.
+static void BenchAutopilot(const PacmanCore& level, int threads, float budget, int maxTicks, size_t tableEntries) {
+    PacmanAutopilot autopilot;
+    autopilot.SetTranspositionTableSize(tableEntries);
+    if (!autopilot.Start(level, threads)) return;
+    PacmanCore game = level;
+    game.Reset();
+    autopilot.Restart();
+
+    long long rolloutsBefore = autopilot.GetRolloutCount(), ticksBefore = autopilot.GetSimulatedTicks();
+    auto start = BenchClock::now();
+    int tick = 0;
+    for (; tick < maxTicks; tick++) {
+        if (game.Step(autopilot.NextAction(game)).done) break;
+        auto frameEnd = BenchClock::now() + std::chrono::duration_cast<BenchClock::duration>(std::chrono::duration<float>(budget));
+        autopilot.Think(budget);
+        std::this_thread::sleep_until(frameEnd);
+    }
+    double seconds = SecondsSince(start);
+    long long rollouts = autopilot.GetRolloutCount() - rolloutsBefore;
+    long long simulated = autopilot.GetSimulatedTicks() - ticksBefore;
+
+    char table[32] = "no table";
+    if (tableEntries > 0) snprintf(table, sizeof(table), "table %4.1f%% hits", autopilot.GetTranspositionHitRate() * 100.0);
+    printf("  %2d threads %4.1f ms/frame  %-16s %9.0f rollouts/s  %6.2f M sim ticks/s  score %5d  lives %d  %s after %d ticks\n",
+           autopilot.GetThreadCount(), budget * 1000.0f, table, rollouts / seconds, simulated / seconds / 1e6,
+           game.GetScore(), game.GetLives(), game.IsVictory() ? "cleared" : game.IsGameOver() ? "game over" : "stopped", tick);
+}
+
+static void RunAutopilotBenchmarks() {
+    printf("autopilot: MCTS over snapshots, root-parallel\n");
+
+    PacmanCore level;
+    if (!level.LoadLevel("level.txt")) {
+        printf("  level.txt not found, skipping\n");
+        return;
+    }
+
+    // Baseline: the random-walk bot from the core benchmark
+    PacmanCore game = level;
+    game.Reset();
+    std::mt19937 rng(42);
+    PacAction action = ACTION_LEFT;
+    for (int i = 0; !game.Step(action).done; i++) {
+        if ((i & 15) == 0) action = (PacAction)(1 + rng() % 4);
+    }
+    printf("  random bot%*sscore %5d\n", 93, "", game.GetScore());
+
+    // Same budget with and without the shared rollout cache
+    int hardware = (int)std::max(1u, std::thread::hardware_concurrency());
+    BenchAutopilot(level, 1, 0.002f, 60 * 60, 0);
+    BenchAutopilot(level, 1, 0.002f, 60 * 60, PacmanAutopilot::DEFAULT_TABLE_ENTRIES);
+    if (hardware > 2) {
+        BenchAutopilot(level, hardware - 1, 0.002f, 60 * 60, 0);
+        BenchAutopilot(level, hardware - 1, 0.002f, 60 * 60, PacmanAutopilot::DEFAULT_TABLE_ENTRIES);
+    }
+}
+
+// Text parse vs. mapping the compiled copy, for one level text.
+static void BenchLevelLoad(const char* label, const std::string& text, int iterations) {
+    std::string textFile = "bench_level.txt", compiledFile = "bench_level.lvlc";
+    FILE* file = fopen(textFile.c_str(), "wb");
+    if (!file) return;
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+    if (!CompileLevelFile(textFile.c_str(), compiledFile.c_str())) return;
+
+    LevelData level;
+    auto start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) ParseLevelFile(textFile.c_str(), level);
+    double parseUs = SecondsSince(start) * 1e6 / iterations;
+
+    start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) LoadCompiledLevel(compiledFile.c_str(), level);
+    double compiledUs = SecondsSince(start) * 1e6 / iterations;
+
+    printf("  %-10s %5dx%-5d text %9.1f us   compiled %9.1f us   %.1fx\n",
+           label, level.width, level.height, parseUs, compiledUs, parseUs / compiledUs);
+    remove(textFile.c_str());
+    remove(compiledFile.c_str());
+}
+
+static bool SameLevelData(const LevelData& a, const LevelData& b) {
+    auto samePellet = [](const LevelPellet& p, const LevelPellet& q) { return p.x == q.x && p.y == q.y && p.isPowerPellet == q.isPowerPellet; };
+    auto sameSpawn = [](const LevelSpawn& p, const LevelSpawn& q) { return p.x == q.x && p.y == q.y; };
+    return a.width == b.width && a.height == b.height && a.walls == b.walls && a.exits == b.exits &&
+           std::equal(a.pellets.begin(), a.pellets.end(), b.pellets.begin(), b.pellets.end(), samePellet) &&
+           std::equal(a.ghosts.begin(), a.ghosts.end(), b.ghosts.begin(), b.ghosts.end(), sameSpawn) &&
+           a.hasPlayer == b.hasPlayer && sameSpawn(a.player, b.player);
+}
+
+// The built-in classic maze: copying its constexpr tables vs. parsing the same text from memory.
+static void BenchEmbeddedLevel(int iterations) {
+    LevelData parsed, embedded;
+    auto start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) ParseLevelText(CLASSIC_LEVEL_TEXT.data(), CLASSIC_LEVEL_TEXT.size(), parsed);
+    double parseUs = SecondsSince(start) * 1e6 / iterations;
+
+    const EmbeddedLevelView* level = FindEmbeddedLevel("level.txt");
+    start = BenchClock::now();
+    for (int i = 0; i < iterations; i++) level->ToLevelData(embedded);
+    double embeddedUs = SecondsSince(start) * 1e6 / iterations;
+
+    printf("  %-10s %5dx%-5d text %9.1f us   embedded %9.1f us   %.1fx  %s\n", "embedded", embedded.width, embedded.height,
+           parseUs, embeddedUs, parseUs / embeddedUs, SameLevelData(parsed, embedded) ? "(same as parsed)" : "(MISMATCH)");
+}
+
+// Checksummed files with a pellet or spawn off the map must be refused, not handed to the game.
+static void CheckCompiledLevelBounds() {
+    LevelData valid;
+    ParseLevelText(CLASSIC_LEVEL_TEXT.data(), CLASSIC_LEVEL_TEXT.size(), valid);
+    const char* fileName = "bench_bounds.lvlc";
+    int rejected = 0, cases = 0;
+    for (int which = 0; which < 3; which++) {
+        LevelData broken = valid, loaded;
+        if (which == 0) broken.player.x = (uint16_t)broken.width;
+        if (which == 1) broken.ghosts.back().y = (uint16_t)broken.height;
+        if (which == 2) broken.pellets.front().x = 0xFFFF;
+        if (!SaveCompiledLevel(fileName, broken, 0)) continue;
+        cases++;
+        if (!LoadCompiledLevel(fileName, loaded)) rejected++;
+    }
+    LevelData loaded;
+    bool validLoads = SaveCompiledLevel(fileName, valid, 0) && LoadCompiledLevel(fileName, loaded);
+    remove(fileName);
+    printf("  off-map player/ghost/pellet: %d of %d files rejected, valid file %s\n", rejected, cases,
+           validLoads ? "loads" : "REJECTED");
+}
+
+static void RunLevelBenchmarks() {
+    printf("level: text parse vs. compiled .lvlc load vs. embedded\n");
+
+    std::vector<std::string> lines;
+    if (LoadLevelLines("level.txt", lines)) {
+        std::string text;
+        for (const auto& line : lines) text += line + "\n";
+        BenchLevelLoad("level.txt", text, 2000);
+    }
+    BenchEmbeddedLevel(20000);
+    CheckCompiledLevelBounds();
+    for (int size : { 200, 1000 }) {
+        std::string text;
+        for (const auto& line : GenerateMazeLines(size, size, 7)) text += line + "\n";
+        BenchLevelLoad(size == 200 ? "200x200" : "1000x1000", text, size == 200 ? 200 : 10);
+    }
+}
+
+// ---------- Pong ----------
+// Fires the ball at speeds from normal play up to far past anything a rally reaches, with
+// frame times up to half a second, and checks that the swept collision never lets it through.
+static const float PONG_WIDTH = 800.0f, PONG_HEIGHT = 450.0f, PONG_RADIUS = 8.0f;
+
+// Full-height paddles make a closed box: the ball must stay inside it forever.
+static long CheckPongClosedBox(float speed, std::mt19937& rng, long& calls, double& seconds) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    PongBox left = { 30.0f, 0.0f, 10.0f, PONG_HEIGHT }, right = { PONG_WIDTH - 40.0f, 0.0f, 10.0f, PONG_HEIGHT };
+    float minX = left.x + left.width + PONG_RADIUS, maxX = right.x - PONG_RADIUS, slack = 0.01f;
+    long escapes = 0;
+    for (int trial = 0; trial < 200; trial++) {
+        float angle = unit(rng) * 6.2831853f;
+        PongBall ball = { { minX + unit(rng) * (maxX - minX), PONG_RADIUS + unit(rng) * (PONG_HEIGHT - 2 * PONG_RADIUS) },
+                          { std::cos(angle) * speed, std::sin(angle) * speed }, PONG_RADIUS };
+        for (int step = 0; step < 50; step++) {
+            float deltaTime = 0.001f + unit(rng) * 0.5f;
+            auto start = BenchClock::now();
+            MovePongBall(ball, left, right, PONG_HEIGHT, deltaTime);
+            seconds += SecondsSince(start);
+            calls++;
+            PongVec2 p = ball.position;
+            if (p.x < minX - slack || p.x > maxX + slack || p.y < PONG_RADIUS - slack || p.y > PONG_HEIGHT - PONG_RADIUS + slack) {
+                escapes++;
+                break;
+            }
+            // Undo the paddle speed-up so the trial stays at its speed
+            float scale = speed / std::sqrt(ball.velocity.x * ball.velocity.x + ball.velocity.y * ball.velocity.y);
+            ball.velocity = { ball.velocity.x * scale, ball.velocity.y * scale };
+        }
+    }
+    return escapes;
+}
+
+// One shot from mid-field at a short paddle: aimed at its face or within a radius of its
+// ends it must bounce, aimed just clear of its ends it must not.
+static long CheckPongShots(float speed, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    PongBox away = { -1e9f, 0.0f, 10.0f, PONG_HEIGHT };
+    long wrong = 0;
+    for (int trial = 0; trial < 200; trial++) {
+        PongBox paddle = { PONG_WIDTH - 40.0f, 100.0f + unit(rng) * 150.0f, 10.0f, 100.0f };
+        float targetY;
+        bool shouldHit = true;
+        switch (trial % 3) {
+            case 0: targetY = paddle.y + unit(rng) * paddle.height; break;
+            case 1: targetY = paddle.y - unit(rng) * PONG_RADIUS * 0.9f; break;
+            default: targetY = paddle.y + paddle.height + PONG_RADIUS * (1.1f + unit(rng)); shouldHit = false; break;
+        }
+        PongBall ball = { { PONG_WIDTH / 2, targetY }, { speed, 0.0f }, PONG_RADIUS };
+        int events = MovePongBall(ball, away, paddle, PONG_HEIGHT, 2.0f);
+        bool hit = (events & PONG_HIT_RIGHT) != 0;
+        if (hit != shouldHit || (hit && ball.position.x > paddle.x)) wrong++;
+    }
+    return wrong;
+}
+
+// PredictPongCrossing() against actually moving the ball that long with MovePongBall().
+static void CheckPongPrediction(std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    PongBox away = { -1e9f, 0.0f, 10.0f, PONG_HEIGHT }, farAway = { 1e9f, 0.0f, 10.0f, PONG_HEIGHT };
+    float faceX = PONG_WIDTH - 40.0f - PONG_RADIUS, worstError = 0.0f;
+    double seconds = 0.0;
+    const int trials = 2000;
+    volatile float sink = 0.0f;
+    for (int trial = 0; trial < trials; trial++) {
+        float speed = 350.0f * (1.0f + unit(rng) * 20.0f), angle = (unit(rng) - 0.5f) * 2.6f;
+        PongBall ball = { { 40.0f + unit(rng) * 300.0f, PONG_RADIUS + unit(rng) * (PONG_HEIGHT - 2 * PONG_RADIUS) },
+                          { std::cos(angle) * speed, std::sin(angle) * speed }, PONG_RADIUS };
+        float crossingY = 0.0f, crossingTime = 0.0f;
+        auto start = BenchClock::now();
+        PredictPongCrossing(ball, faceX, PONG_HEIGHT, crossingY, crossingTime);
+        seconds += SecondsSince(start);
+        sink = sink + crossingY;
+
+        for (float left = crossingTime; left > 0.0f; left -= 1.0f / 240) {
+            MovePongBall(ball, away, farAway, PONG_HEIGHT, std::fmin(left, 1.0f / 240));
+        }
+        worstError = std::fmax(worstError, std::fabs(ball.position.y - crossingY));
+    }
+    printf("  prediction  %d shots  worst error %.3f px  %.1f ns/prediction\n", trials, worstError, seconds * 1e9 / trials);
+}
+
+static void RunPongBenchmarks() {
+    printf("pong: swept ball collision (MovePongBall) and AI prediction\n");
+    std::mt19937 rng(46);
+    for (float speed : { 350.0f, 5e3f, 1e5f, 1e6f, 1e7f, 1e8f }) {
+        long calls = 0;
+        double seconds = 0.0;
+        long escapes = CheckPongClosedBox(speed, rng, calls, seconds);
+        long wrongShots = CheckPongShots(speed, rng);
+        printf("  %10.0f px/s  %4ld escapes from closed box  %3ld wrong paddle shots  %7.1f ns/frame\n",
+               speed, escapes, wrongShots, seconds * 1e9 / calls);
+    }
+    CheckPongPrediction(rng);
+}
+
+// Step() time against the ball count, with and without ball-to-ball bounces, after a
+// second of play to let the balls spread out; also checks none ever leaves the field.
+static void RunChaosBenchmarks() {
+    printf("chaos: multi-ball Pong step (PongChaos), %d balls per SIMD step\n", PongChaos::LANES);
+    const int warmupTicks = 240, timedTicks = 960;
+    const int ticksPerFrame = (int)(PongCore::TICK_RATE / 60);
+    for (bool collisions : { false, true }) {
+        for (int count : { 256, 1024, 4096, 16384 }) {
+            PongChaos chaos;
+            chaos.Reset(count, 50);
+            chaos.SetBallCollisions(collisions);
+            for (int tick = 0; tick < warmupTicks; tick++) chaos.Step(PONG_ACTION_NONE);
+
+            long contacts = 0, escapes = 0;
+            double seconds = 0.0;
+            for (int tick = 0; tick < timedTicks; tick++) {
+                auto start = BenchClock::now();
+                chaos.Step(PONG_ACTION_NONE);
+                seconds += SecondsSince(start);
+                contacts += chaos.GetLastContacts();
+                for (int i = 0; i < count; i++) {
+                    if (!(chaos.y[i] >= 0.0f && chaos.y[i] <= 720.0f && std::fabs(chaos.x[i]) <= 2000.0f)) escapes++;
+                }
+            }
+            printf("  %-13s %6d balls  %8.1f us/tick  %6.2f ms per 60 Hz frame  %8.1f contacts/tick  %ld escapes\n",
+                   collisions ? "collisions" : "no collisions", count, seconds * 1e6 / timedTicks,
+                   seconds * 1e3 * ticksPerFrame / timedTicks, (double)contacts / timedTicks, escapes);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    auto wanted = [&](const char* name) { return !only || strcmp(only, name) == 0; };
+
+    if (wanted("bfs")) RunBfsBenchmarks();
+    if (wanted("apsp")) RunApspBenchmarks();
+    if (wanted("core")) RunCoreBenchmarks();
+    if (wanted("batch")) RunBatchBenchmarks();
+    if (wanted("parity")) RunParityBenchmarks();
+    if (wanted("level")) RunLevelBenchmarks();
+    if (wanted("swarm")) RunSwarmBenchmarks();
+    if (wanted("snapshot")) RunSnapshotBenchmarks();
+    if (wanted("zobrist")) RunZobristBenchmarks();
+    if (wanted("replay")) RunReplayBenchmarks(argc > 2 ? argv[2] : nullptr);
+    if (wanted("autopilot")) RunAutopilotBenchmarks();
+    if (wanted("pong")) RunPongBenchmarks();
+    if (wanted("chaos")) RunChaosBenchmarks();
+    return 0;
+}
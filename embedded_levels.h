@@ -0,0 +1,193 @@
+/*******************************************************************************************
+*
+* embedded_levels.h - Levels parsed at compile time and built into the executable
+*
+* A level written as a string literal is turned into wall bits, exit masks, a pellet table
+* and spawn points by constexpr code, so it costs no file I/O and no parsing at startup and
+* the web build doesn't need it in index.data:
+*
+*     inline constexpr EmbeddedLevelSize MY_LEVEL_SIZE = MeasureLevelText(MY_LEVEL_TEXT);
+*     inline constexpr auto MY_LEVEL = ParseEmbeddedLevel<MY_LEVEL_SIZE.width, MY_LEVEL_SIZE.height,
+*         MY_LEVEL_SIZE.pelletCount, MY_LEVEL_SIZE.ghostCount>(MY_LEVEL_TEXT);
+*
+* and listed in EMBEDDED_LEVELS under the file name it stands in for. PacmanCore::LoadLevel()
+* uses an embedded level only when its file can't be loaded, so a level.txt next to the
+* executable still overrides the built-in one.
+*
+* The text format and results are exactly those of ParseLevelText(), so an embedded level and
+* the same text loaded from a file have the same level hash (and share replays).
+*
+********************************************************************************************/
+#pragma once
+
+#include "level_file.h"
+#include "maze.h"
+#include <string_view>
+#include <cstring>
+
+// ---------- Parser ----------
+struct EmbeddedLevelSize { int width = 0, height = 0, pelletCount = 0, ghostCount = 0; };
+
+// First pass of ParseLevelText(): sizes for the template arguments below.
+constexpr EmbeddedLevelSize MeasureLevelText(std::string_view text) {
+    EmbeddedLevelSize size;
+    int lineLength = 0;
+    for (char c : text) {
+        if (c == '\n') {
+            size.width = lineLength > size.width ? lineLength : size.width;
+            size.height++;
+            lineLength = 0;
+            continue;
+        }
+        if (c == '\r') continue;
+        if (c == '.' || c == 'O') size.pelletCount++;
+        if (c == 'G') size.ghostCount++;
+        lineLength++;
+    }
+    if (lineLength > 0) {
+        size.width = lineLength > size.width ? lineLength : size.width;
+        size.height++;
+    }
+    return size;
+}
+
+// Type-erased view of an EmbeddedLevel, for the EMBEDDED_LEVELS table.
+struct EmbeddedLevelView {
+    const char* name;          // File name the level stands in for
+    int width, height;
+    const uint64_t* wallBits;  // Row-major, bit i of word i / 64 set = wall
+    const uint8_t* exits;      // Row-major EXIT_* bits
+    const LevelPellet* pellets;
+    int pelletCount;
+    const LevelSpawn* ghosts;
+    int ghostCount;
+    bool hasPlayer;
+    LevelSpawn player;
+
+    // Copies out the tables; nothing is parsed or derived.
+    void ToLevelData(LevelData& level) const {
+        level.width = width;
+        level.height = height;
+        level.walls.resize((size_t)width * height);
+        for (size_t i = 0; i < level.walls.size(); i++) level.walls[i] = (uint8_t)((wallBits[i >> 6] >> (i & 63)) & 1);
+        level.exits.assign(exits, exits + (size_t)width * height);
+        level.pellets.assign(pellets, pellets + pelletCount);
+        level.ghosts.assign(ghosts, ghosts + ghostCount);
+        level.hasPlayer = hasPlayer;
+        level.player = player;
+    }
+};
+
+template <int Width, int Height, int PelletCount, int GhostCount>
+struct EmbeddedLevel {
+    static constexpr int TILE_COUNT = Width * Height;
+
+    uint64_t wallBits[(TILE_COUNT + 63) / 64] = {};
+    uint8_t exits[TILE_COUNT > 0 ? TILE_COUNT : 1] = {};
+    LevelPellet pellets[PelletCount > 0 ? PelletCount : 1] = {};
+    LevelSpawn ghosts[GhostCount > 0 ? GhostCount : 1] = {};
+    bool hasPlayer = false;
+    LevelSpawn player = {0, 0};
+
+    // Outside the map counts as a wall, as in TileGrid::IsWall().
+    constexpr bool IsWall(int x, int y) const {
+        if (x < 0 || x >= Width || y < 0 || y >= Height) return true;
+        int i = y * Width + x;
+        return (wallBits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    constexpr EmbeddedLevelView View(const char* name) const {
+        return { name, Width, Height, wallBits, exits, pellets, PelletCount, ghosts, GhostCount, hasPlayer, player };
+    }
+};
+
+// Second pass of ParseLevelText(), plus TileGrid::BuildExits().
+template <int Width, int Height, int PelletCount, int GhostCount>
+constexpr EmbeddedLevel<Width, Height, PelletCount, GhostCount> ParseEmbeddedLevel(std::string_view text) {
+    EmbeddedLevel<Width, Height, PelletCount, GhostCount> level{};
+    int x = 0, y = 0, pelletCount = 0, ghostCount = 0;
+    for (char c : text) {
+        if (c == '\n') { x = 0; y++; continue; }
+        if (c == '\r') continue;
+        uint16_t tx = (uint16_t)x, ty = (uint16_t)y;
+        int i = y * Width + x;
+        switch (c) {
+            case '#': level.wallBits[i >> 6] |= 1ull << (i & 63); break;
+            case '.': level.pellets[pelletCount++] = { tx, ty, false }; break;
+            case 'O': level.pellets[pelletCount++] = { tx, ty, true }; break;
+            case 'P': level.player = { tx, ty }; level.hasPlayer = true; break;
+            case 'G': level.ghosts[ghostCount++] = { tx, ty }; break;
+        }
+        x++;
+    }
+
+    for (int ty = 0; ty < Height; ty++) {
+        for (int tx = 0; tx < Width; tx++) {
+            uint8_t mask = 0;
+            if (!level.IsWall(tx, ty - 1)) mask |= EXIT_UP;
+            if (!level.IsWall(tx, ty + 1)) mask |= EXIT_DOWN;
+            if (!level.IsWall(tx - 1, ty)) mask |= EXIT_LEFT;
+            if (!level.IsWall(tx + 1, ty)) mask |= EXIT_RIGHT;
+            level.exits[ty * Width + tx] = mask;
+        }
+    }
+    return level;
+}
+
+// ---------- Levels ----------
+// The classic maze, the same as the shipped level.txt.
+inline constexpr std::string_view CLASSIC_LEVEL_TEXT =
+    "############################\n"
+    "#O...........##...........O#\n"
+    "#.####.#####.##.#####.####.#\n"
+    "#.####.#####.##.#####.####.#\n"
+    "#.####.#####.##.#####.####.#\n"
+    "#..........................#\n"
+    "#.####.##.########.##.####.#\n"
+    "#.####.##.########.##.####.#\n"
+    "#......##....##....##......#\n"
+    "######.##### ## #####.######\n"
+    "     #.##..........##.#     \n"
+    "     #.##.###  ###.##.#     \n"
+    "     #.##.# GGGG #.##.#     \n"
+    "######.##.########.##.######\n"
+    "#     .......P........     #\n"
+    "######.##.########.##.######\n"
+    "     #.##..........##.#     \n"
+    "     #.##.########.##.#     \n"
+    "######.##.########.##.######\n"
+    "#............##............#\n"
+    "#.####.#####.##.#####.####.#\n"
+    "#.####.#####.##.#####.####.#\n"
+    "#O..##................##..O#\n"
+    "###.##.##.########.##.##.###\n"
+    "###.##.##.########.##.##.###\n"
+    "#......##....##....##......#\n"
+    "#.##########.##.##########.#\n"
+    "#.##########.##.##########.#\n"
+    "#..........................#\n"
+    "############################";
+
+inline constexpr EmbeddedLevelSize CLASSIC_LEVEL_SIZE = MeasureLevelText(CLASSIC_LEVEL_TEXT);
+inline constexpr auto CLASSIC_LEVEL = ParseEmbeddedLevel<CLASSIC_LEVEL_SIZE.width, CLASSIC_LEVEL_SIZE.height,
+    CLASSIC_LEVEL_SIZE.pelletCount, CLASSIC_LEVEL_SIZE.ghostCount>(CLASSIC_LEVEL_TEXT);
+
+static_assert(CLASSIC_LEVEL_SIZE.width == 28 && CLASSIC_LEVEL_SIZE.height == 30, "classic maze is 28x30");
+static_assert(CLASSIC_LEVEL.hasPlayer && CLASSIC_LEVEL_SIZE.ghostCount == 4, "classic maze needs a player and 4 ghosts");
+
+inline constexpr EmbeddedLevelView EMBEDDED_LEVELS[] = {
+    CLASSIC_LEVEL.View("level.txt"),
+};
+
+// Embedded level standing in for 'fileName' (matched on the name without its directory),
+// or nullptr.
+inline const EmbeddedLevelView* FindEmbeddedLevel(const char* fileName) {
+    const char* name = fileName;
+    for (const char* c = fileName; *c; c++) {
+        if (*c == '/' || *c == '\\') name = c + 1;
+    }
+    for (const EmbeddedLevelView& level : EMBEDDED_LEVELS) {
+        if (std::strcmp(level.name, name) == 0) return &level;
+    }
+    return nullptr;
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************************
+*
+* file_watcher.h - Non-blocking "has this file changed?" checks for hot reloading
+*
+* On Linux the watcher uses inotify on each file's directory, so the check is one read()
+* that returns at once when nothing happened. Watching the directory rather than the file
+* catches editors that save by writing a new file and renaming it over the old one. Other
+* platforms fall back to comparing modification times every POLL_INTERVAL seconds.
+*
+*     FileWatcher watcher;
+*     watcher.Watch("level.txt");
+*     ...
+*     for (const std::string& file : watcher.Poll()) Reload(file);   // every frame
+*
+* A burst of writes to one file (truncate, write, close) is reported once per Poll().
+*
+********************************************************************************************/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+    #define FILE_WATCHER_INOTIFY
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    #include <climits>
+#endif
+
+class FileWatcher {
+public:
+    static constexpr float POLL_INTERVAL = 0.5f; // Seconds between mtime checks (fallback only)
+
+    FileWatcher() = default;
+    ~FileWatcher() { Clear(); }
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Starts watching 'path'. The file doesn't have to exist yet.
+    bool Watch(const std::string& path) {
+        Entry entry;
+        entry.path = path;
+        std::filesystem::path full(path);
+        entry.name = full.filename().string();
+        entry.lastWrite = LastWrite(path);
+#ifdef FILE_WATCHER_INOTIFY
+        if (fd < 0) fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+        std::string dir = full.parent_path().string();
+        if (dir.empty()) dir = ".";
+        entry.watch = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (entry.watch < 0) return false;
+#endif
+        entries.push_back(entry);
+        return true;
+    }
+
+    void Clear() {
+#ifdef FILE_WATCHER_INOTIFY
+        if (fd >= 0) close(fd);
+        fd = -1;
+#endif
+        entries.clear();
+    }
+
+    bool IsNative() const {
+#ifdef FILE_WATCHER_INOTIFY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Paths (as passed to Watch()) that changed since the last call. Never blocks.
+    std::vector<std::string> Poll() {
+        std::vector<std::string> changed;
+#ifdef FILE_WATCHER_INOTIFY
+        if (fd < 0) return changed;
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t length = read(fd, buffer, sizeof(buffer));
+            if (length <= 0) break;
+            for (char* p = buffer; p < buffer + length; ) {
+                const inotify_event* event = (const inotify_event*)p;
+                p += sizeof(inotify_event) + event->len;
+                if (event->len == 0) continue;
+                for (const Entry& entry : entries) {
+                    if (entry.watch == event->wd && entry.name == event->name) AddOnce(changed, entry.path);
+                }
+            }
+        }
+#else
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<float>(now - lastPoll).count() < POLL_INTERVAL) return changed;
+        lastPoll = now;
+        for (Entry& entry : entries) {
+            auto time = LastWrite(entry.path);
+            if (time == entry.lastWrite) continue;
+            entry.lastWrite = time;
+            AddOnce(changed, entry.path);
+        }
+#endif
+        return changed;
+    }
+
+private:
+    struct Entry {
+        std::string path, name;
+        std::filesystem::file_time_type lastWrite;
+        int watch = -1;
+    };
+
+    std::vector<Entry> entries;
+#ifdef FILE_WATCHER_INOTIFY
+    int fd = -1;
+#else
+    std::chrono::steady_clock::time_point lastPoll = std::chrono::steady_clock::now();
+#endif
+
+    static std::filesystem::file_time_type LastWrite(const std::string& path) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+
+    static void AddOnce(std::vector<std::string>& list, const std::string& path) {
+        if (std::find(list.begin(), list.end(), path) == list.end()) list.push_back(path);
+    }
+};
@@ -0,0 +1,329 @@
+/*******************************************************************************************
+*
+* level_file.cpp - Level parsing, compiled binary levels and the compiled-level cache
+*
+********************************************************************************************/
+#include "level_file.h"
+#include "maze.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Helpers
+//----------------------------------------------------------------------------------
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= 0x100000001b3ull;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Mixing in the format version means a format change never reuses stale cache files.
+uint64_t LevelSourceHash(const void* text, size_t length) {
+    return HashBytes(text, length, 0xcbf29ce484222325ull ^ COMPILED_LEVEL_VERSION);
+}
+
+static bool ReadWholeFile(const char* fileName, std::vector<char>& contents) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    contents.resize(size > 0 ? (size_t)size : 0);
+    size_t read = contents.empty() ? 0 : fread(contents.data(), 1, contents.size(), file);
+    fclose(file);
+    return read == contents.size();
+}
+
+// Read-only view of a whole file. Memory-mapped where the platform allows it, read into
+// a buffer otherwise (web builds).
+class MappedFile {
+public:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    bool Open(const char* fileName) {
+#if defined(_WIN32)
+        file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        size = (size_t)fileSize.QuadPart;
+        return data != nullptr;
+#elif !defined(__EMSCRIPTEN__)
+        fd = open(fileName, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) return false;
+        void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) return false;
+        data = (const uint8_t*)view;
+        size = (size_t)info.st_size;
+        return true;
+#else
+        std::vector<char> contents;
+        if (!ReadWholeFile(fileName, contents) || contents.empty()) return false;
+        buffer.assign(contents.begin(), contents.end());
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#elif !defined(__EMSCRIPTEN__)
+        if (data) munmap((void*)data, size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#elif !defined(__EMSCRIPTEN__)
+    int fd = -1;
+#else
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+//----------------------------------------------------------------------------------
+// Text Levels
+//----------------------------------------------------------------------------------
+
+void ParseLevelText(const char* text, size_t length, LevelData& level) {
+    // First pass: dimensions, so everything below is sized exactly once.
+    int width = 0, height = 0, lineLength = 0;
+    size_t pelletCount = 0, ghostCount = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c == '\n') {
+            width = std::max(width, lineLength);
+            height++;
+            lineLength = 0;
+            continue;
+        }
+        if (c == '\r') continue;
+        if (c == '.' || c == 'O') pelletCount++;
+        if (c == 'G') ghostCount++;
+        lineLength++;
+    }
+    if (lineLength > 0) {
+        width = std::max(width, lineLength);
+        height++;
+    }
+
+    level.width = width;
+    level.height = height;
+    level.walls.assign((size_t)width * height, 0);
+    level.pellets.clear();
+    level.pellets.reserve(pelletCount);
+    level.ghosts.clear();
+    level.ghosts.reserve(ghostCount);
+    level.hasPlayer = false;
+    level.player = {0, 0};
+
+    int x = 0, y = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c == '\n') { x = 0; y++; continue; }
+        if (c == '\r') continue;
+        uint16_t tx = (uint16_t)x, ty = (uint16_t)y;
+        switch (c) {
+            case '#': level.walls[(size_t)y * width + x] = 1; break;
+            case '.': level.pellets.push_back({ tx, ty, false }); break;
+            case 'O': level.pellets.push_back({ tx, ty, true }); break;
+            case 'P': level.player = { tx, ty }; level.hasPlayer = true; break;
+            case 'G': level.ghosts.push_back({ tx, ty }); break;
+        }
+        x++;
+    }
+
+    TileGrid grid;
+    grid.width = width;
+    grid.height = height;
+    grid.walls = level.walls;
+    grid.BuildExits();
+    level.exits = std::move(grid.exits);
+}
+
+bool ParseLevelFile(const char* fileName, LevelData& level) {
+    std::vector<char> text;
+    if (!ReadWholeFile(fileName, text)) return false;
+    ParseLevelText(text.data(), text.size(), level);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Compiled Levels
+//----------------------------------------------------------------------------------
+
+bool SaveCompiledLevel(const char* fileName, const LevelData& level, uint64_t sourceHash) {
+    size_t tiles = (size_t)level.width * level.height;
+
+    std::vector<uint8_t> payload;
+    payload.reserve(tiles * 2 + level.pellets.size() * sizeof(CompiledPellet) + level.ghosts.size() * sizeof(CompiledSpawn));
+    payload.insert(payload.end(), level.walls.begin(), level.walls.end());
+    payload.insert(payload.end(), level.exits.begin(), level.exits.end());
+    for (const auto& p : level.pellets) {
+        CompiledPellet out = { p.x, p.y, (uint8_t)(p.isPowerPellet ? 1 : 0) };
+        payload.insert(payload.end(), (const uint8_t*)&out, (const uint8_t*)&out + sizeof(out));
+    }
+    for (const auto& g : level.ghosts) {
+        CompiledSpawn out = { g.x, g.y };
+        payload.insert(payload.end(), (const uint8_t*)&out, (const uint8_t*)&out + sizeof(out));
+    }
+
+    CompiledLevelHeader header;
+    memcpy(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic));
+    header.version = COMPILED_LEVEL_VERSION;
+    header.width = (uint32_t)level.width;
+    header.height = (uint32_t)level.height;
+    header.pelletCount = (uint32_t)level.pellets.size();
+    header.ghostCount = (uint32_t)level.ghosts.size();
+    header.hasPlayer = level.hasPlayer ? 1 : 0;
+    header.playerX = level.player.x;
+    header.playerY = level.player.y;
+    header.sourceHash = sourceHash;
+    header.payloadSize = payload.size();
+    header.payloadHash = HashBytes(payload.data(), payload.size());
+
+    // Write to a temporary name and rename, so a reader never maps a half-written file.
+    std::string tempName = std::string(fileName) + ".tmp";
+    FILE* file = fopen(tempName.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !payload.empty()) ok = fwrite(payload.data(), payload.size(), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(tempName, fileName, error);
+    if (!ok || error) {
+        std::filesystem::remove(tempName, error);
+        return false;
+    }
+    return true;
+}
+
+bool LoadCompiledLevel(const char* fileName, LevelData& level, uint64_t* sourceHash) {
+    MappedFile file;
+    if (!file.Open(fileName) || file.size < sizeof(CompiledLevelHeader)) return false;
+
+    CompiledLevelHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    if (memcmp(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != COMPILED_LEVEL_VERSION) return false;
+
+    uint64_t tiles = (uint64_t)header.width * header.height;
+    uint64_t expected = tiles * 2 + header.pelletCount * sizeof(CompiledPellet) + header.ghostCount * sizeof(CompiledSpawn);
+    if (header.payloadSize != expected || file.size != sizeof(header) + expected) return false;
+
+    const uint8_t* payload = file.data + sizeof(header);
+    if (HashBytes(payload, (size_t)header.payloadSize) != header.payloadHash) return false;
+
+    level.width = (int)header.width;
+    level.height = (int)header.height;
+    level.walls.assign(payload, payload + tiles);
+    level.exits.assign(payload + tiles, payload + tiles * 2);
+
+    // A valid checksum only proves the file is what was written; a stale or hand-built one
+    // can still place things off the map, which the game would index with unchecked.
+    auto onMap = [&](uint16_t x, uint16_t y) { return x < header.width && y < header.height; };
+
+    const uint8_t* cursor = payload + tiles * 2;
+    level.pellets.resize(header.pelletCount);
+    for (auto& p : level.pellets) {
+        CompiledPellet in;
+        memcpy(&in, cursor, sizeof(in));
+        cursor += sizeof(in);
+        if (!onMap(in.x, in.y)) return false;
+        p = { in.x, in.y, in.isPowerPellet != 0 };
+    }
+    level.ghosts.resize(header.ghostCount);
+    memcpy(level.ghosts.data(), cursor, header.ghostCount * sizeof(CompiledSpawn));
+    for (const auto& g : level.ghosts) {
+        if (!onMap(g.x, g.y)) return false;
+    }
+
+    level.hasPlayer = header.hasPlayer != 0;
+    level.player = { header.playerX, header.playerY };
+    if (level.hasPlayer && !onMap(level.player.x, level.player.y)) return false;
+    if (sourceHash) *sourceHash = header.sourceHash;
+    return true;
+}
+
+bool CompileLevelFile(const char* textFileName, const char* compiledFileName) {
+    std::vector<char> text;
+    if (!ReadWholeFile(textFileName, text)) return false;
+    LevelData level;
+    ParseLevelText(text.data(), text.size(), level);
+    return SaveCompiledLevel(compiledFileName, level, LevelSourceHash(text.data(), text.size()));
+}
+
+//----------------------------------------------------------------------------------
+// Cache
+//----------------------------------------------------------------------------------
+
+bool LoadLevelCached(const char* textFileName, LevelData& level, const char* cacheDir, bool* cacheHit) {
+    if (cacheHit) *cacheHit = false;
+
+    std::vector<char> text;
+    if (!ReadWholeFile(textFileName, text)) return false;
+
+    // One cache file per text file, named after its path and overwritten when the text
+    // changes (the header's source hash says which text it holds), so editing a level over
+    // and over doesn't pile up compiled copies of every version
+    std::error_code error;
+    std::filesystem::path sourcePath = std::filesystem::weakly_canonical(textFileName, error);
+    if (error) sourcePath = textFileName;
+    std::string pathText = sourcePath.generic_string();
+    char name[32];
+    snprintf(name, sizeof(name), "-%016llx.lvlc", (unsigned long long)HashBytes(pathText.data(), pathText.size()));
+    std::string cachePath = std::string(cacheDir) + "/" + sourcePath.stem().string() + name;
+
+    uint64_t sourceHash = LevelSourceHash(text.data(), text.size());
+
+    uint64_t cachedHash = 0;
+    if (LoadCompiledLevel(cachePath.c_str(), level, &cachedHash) && cachedHash == sourceHash) {
+        if (cacheHit) *cacheHit = true;
+        return true;
+    }
+
+    ParseLevelText(text.data(), text.size(), level);
+
+    std::filesystem::create_directories(cacheDir, error);
+    if (!error) SaveCompiledLevel(cachePath.c_str(), level, sourceHash);
+    return true;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************************
+*
+* level_file.h - Level parsing, compiled binary levels and the compiled-level cache
+*
+* Text levels (level.txt) are convenient to edit but slow to load in bulk. A compiled level
+* (.lvlc) stores everything LoadLevel derives from the text, ready to use:
+*
+*     CompiledLevelHeader   magic, version, sizes, source hash, payload checksum
+*     walls[w*h]            1 = wall
+*     exits[w*h]            EXIT_* bits for each tile
+*     pellets[pelletCount]  CompiledPellet
+*     ghosts[ghostCount]    CompiledSpawn
+*
+* Compiled files are memory-mapped and checksummed on load. LoadLevelCached() keeps one
+* compiled file per text file, named after its path, and reparses only when the text's hash
+* no longer matches the one in its header.
+*
+********************************************************************************************/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// ---------- In-memory level ----------
+struct LevelPellet { uint16_t x, y; bool isPowerPellet; };
+struct LevelSpawn { uint16_t x, y; };
+
+struct LevelData {
+    int width = 0, height = 0;
+    std::vector<uint8_t> walls;   // Row-major, 1 = wall
+    std::vector<uint8_t> exits;   // Row-major EXIT_* bits
+    std::vector<LevelPellet> pellets;
+    std::vector<LevelSpawn> ghosts;
+    bool hasPlayer = false;
+    LevelSpawn player = {0, 0};
+};
+
+// ---------- Compiled file layout ----------
+static constexpr char COMPILED_LEVEL_MAGIC[4] = { 'N', 'S', 'L', 'V' };
+static constexpr uint32_t COMPILED_LEVEL_VERSION = 1;
+
+#pragma pack(push, 1)
+struct CompiledLevelHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t pelletCount, ghostCount;
+    uint32_t hasPlayer;
+    uint16_t playerX, playerY;
+    uint64_t sourceHash;     // Hash of the text level this was compiled from
+    uint64_t payloadSize;    // Bytes after the header
+    uint64_t payloadHash;    // Checksum of those bytes
+};
+struct CompiledPellet { uint16_t x, y; uint8_t isPowerPellet; };
+struct CompiledSpawn { uint16_t x, y; };
+#pragma pack(pop)
+
+// FNV-1a style hash over 64-bit words, used for both the source hash and the payload checksum.
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+uint64_t LevelSourceHash(const void* text, size_t length);
+
+// Parses level text ('#' wall, '.' pellet, 'O' power pellet, 'P' player, 'G' ghost).
+void ParseLevelText(const char* text, size_t length, LevelData& level);
+bool ParseLevelFile(const char* fileName, LevelData& level);
+
+// Writes / maps compiled levels. LoadCompiledLevel() rejects files with a bad magic,
+// version, size or checksum, or with a pellet or spawn outside the map.
+bool SaveCompiledLevel(const char* fileName, const LevelData& level, uint64_t sourceHash);
+bool LoadCompiledLevel(const char* fileName, LevelData& level, uint64_t* sourceHash = nullptr);
+
+// Converts a text level to a compiled one (what the levelc tool does).
+bool CompileLevelFile(const char* textFileName, const char* compiledFileName);
+
+// Loads a text level through the cache in cacheDir, compiling it on a miss.
+// cacheHit reports whether the compiled copy was used.
+bool LoadLevelCached(const char* textFileName, LevelData& level, const char* cacheDir = "level_cache", bool* cacheHit = nullptr);
@@ -0,0 +1,49 @@
+/*******************************************************************************************
+*
+* levelc - Compiles a text level (level.txt format) into a binary .lvlc level
+*
+*   g++ -O2 -std=c++17 levelc.cpp level_file.cpp -o levelc
+*   ./levelc level.txt level.lvlc
+*
+********************************************************************************************/
+#include "level_file.h"
+#include "maze.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: levelc <level.txt> [output.lvlc]\n");
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string output = argc > 2 ? argv[2] : input.substr(0, input.find_last_of('.')) + ".lvlc";
+
+    if (!CompileLevelFile(input.c_str(), output.c_str())) {
+        printf("levelc: failed to compile %s\n", input.c_str());
+        return 1;
+    }
+
+    LevelData level;
+    if (!LoadCompiledLevel(output.c_str(), level)) {
+        printf("levelc: %s did not verify after writing\n", output.c_str());
+        return 1;
+    }
+    printf("levelc: %s -> %s (%dx%d, %d pellets, %d ghosts)\n", input.c_str(), output.c_str(),
+           level.width, level.height, (int)level.pellets.size(), (int)level.ghosts.size());
+
+    // A pellet the player can't walk to makes the level impossible to clear
+    TileGrid grid;
+    grid.width = level.width;
+    grid.height = level.height;
+    grid.walls = level.walls;
+    grid.exits = level.exits;
+    MazeAnalysis maze;
+    if (level.hasPlayer) maze.Build(grid, level.player.x, level.player.y);
+    else maze.Build(grid, -1, -1);
+    for (const auto& p : level.pellets) {
+        if (!maze.IsReachable(p.x, p.y)) printf("levelc: warning: pellet at %d,%d is unreachable from the player start\n", p.x, p.y);
+    }
+    return 0;
+}
@@ -10,8 +10,14 @@
 * -- CONTROLS --
 * - LEFT/RIGHT ARROW KEYS: Switch between channels.
 * - GAME-SPECIFIC CONTROLS:
-* - Pac-Man: WASD keys to move.
-* - Pong: W and S keys to move the paddle.
+* - Pac-Man: WASD keys to move. Levels follow campaign.txt (level.txt alone if it is missing);
+*   M switches between the campaign and a generated 1001x1001 maze.
+*   G cycles the ghost swarm stress test (1000 / 4000 / 16000 ghosts, then back to normal).
+*   Hold R to rewind up to five seconds. P replays the session so far ([ and ] seek 10 s).
+*   I toggles the tree-search autopilot. O shows the tiles and chunks repainted each frame.
+* - Pong: W and S keys to move the paddle. TAB cycles the AI (Chase, Easy, Normal, Hard).
+*   C cycles chaos mode (256 / 1024 / 4096 balls at once, then back to normal); B toggles
+*   ball-to-ball bounces in it.
 *
 * -- HOW TO ADD A NEW CHANNEL --
 * 1. Create a new class that inherits from the `IChannel` base class.
@@ -22,11 +28,21 @@
 ********************************************************************************************/
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+#include "pacman_core.h"
+#include "pacman_replay.h"
+#include "pacman_autopilot.h"
+#include "pacman_campaign.h"
+#include "file_watcher.h"
+#include "sfx_pool.h"
+#include "pong_core.h"
+#include "pong_chaos.h"
 #include <vector>
 #include <string>
 #include <cmath>
 #include <fstream>
 #include <algorithm>
+#include <filesystem>
 
 const int screenWidth = 1280;
 const int screenHeight = 720;
@@ -60,341 +76,740 @@ public:
 };
 
 // ---------- PacmanChannel ----------
+// Input, audio and drawing around the headless PacmanCore (pacman_core.h).
 class PacmanChannel : public IChannel {
 private:
     //----------------------------------------------------------------------------------
     // Types and Structures Definition
     //----------------------------------------------------------------------------------
 
-    static constexpr float TILE_SIZE = 24.0f;
+    static constexpr float TILE_SIZE = PacmanCore::TILE_SIZE;
+    static constexpr float TICK_DT = PacmanCore::TICK_DT;
+    static constexpr float MAX_FRAME_TIME = 0.25f; // Drop time beyond this instead of spiralling
+
+    // The maze is drawn in CHUNK_TILES x CHUNK_TILES blocks, each cached as a texture. An
+    // eaten or blinking pellet repaints just its tile; whole chunks are redrawn only when they
+    // come into view or the level resets. Only chunks under the camera are drawn, so the cost
+    // per frame depends on the screen size and on what changed, not on the maze size.
+    static constexpr int CHUNK_TILES = 16;
+    static constexpr float CHUNK_SIZE = CHUNK_TILES * TILE_SIZE;
+    static constexpr int CHUNK_CACHE_SIZE = 32; // A 1280x720 view touches at most 5x3 chunks
+    static constexpr float POWER_PELLET_BLINK = 0.25f; // Seconds on, then as long off
+    static constexpr int GENERATED_MAZE_SIZE = 1001;
+    static constexpr int OVERLAY_LINE_HEIGHT = 25;     // Stats lines, stacked from the top left
+    static constexpr const char* LEVEL_FILE = "level.txt";        // Played alone if there is no campaign
+    static constexpr const char* CAMPAIGN_FILE = "campaign.txt";  // Both reload in place whenever saved
+
+    // Ghost swarm stress test. Every ghost is the same white circle sprite drawn with a tint,
+    // so raylib batches the whole swarm into a handful of draw calls.
+    static constexpr int SWARM_SIZES[] = { 0, 1000, 4000, 16000 };
+    static constexpr int SWARM_SIZE_COUNT = sizeof(SWARM_SIZES) / sizeof(SWARM_SIZES[0]);
+    static constexpr int GHOST_SPRITE_SIZE = 32;
+
+    static constexpr int REWIND_TICKS = 5 * 60; // Ticks of snapshot history kept for rewind
+    static constexpr int REPLAY_SEEK_TICKS = 10 * 60;
+    static constexpr const char* REPLAY_FILE = "replays/last_session.nsrp";
+    static constexpr float AUTOPILOT_BUDGET = 0.008f; // Search time granted per frame, half a 60 Hz frame
+
+    struct ChunkTexture {
+        RenderTexture2D target;
+        int chunk = -1;             // Chunk index held in this slot, -1 if free
+        unsigned version = 0;       // chunkVersion[chunk] when it was rendered
+        unsigned lastUsedFrame = 0;
+    };
 
-    enum GhostType { BLINKY, PINKY, INKY, CLYDE };
-    enum GhostState { CHASING, FRIGHTENED, EATEN };
-    enum RoundState { READY, PLAYING, PLAYER_DYING };
+    //----------------------------------------------------------------------------------
+    // Game State and Asset Variables
+    //----------------------------------------------------------------------------------
 
-    struct Player {
-        Vector2 position, startPosition, direction = {0, 0}, desiredDirection = {0, 0};
-        float speed = 2.8f;
-        float radius = TILE_SIZE / 2.0f - 2.0f;
-    };
+    PacmanCore game;
+    bool useGeneratedMaze = false;
+
+    // Levels are played in campaign order. The next one is loaded on the preloader's thread
+    // while this one is played, so clearing a level swaps cores instead of loading.
+    std::vector<CampaignLevel> campaign;
+    int levelIndex = 0;
+    LevelPreloader preloader;
+    bool advancing = false; // Level cleared, waiting to swap in the next one
+
+    int chunksX = 0, chunksY = 0;
+    std::vector<int> chunkPelletStart;   // Pellets of chunk c are chunkPellets[start[c] .. start[c + 1])
+    std::vector<int> chunkPellets;       // Indices into game.GetPellets(), grouped by chunk
+    std::vector<unsigned> chunkVersion;  // Bumped whenever a chunk's pellets change
+    std::vector<int> chunkSlot;          // Chunk -> chunkCache slot, -1 if not cached
+    std::vector<ChunkTexture> chunkCache;
+    std::vector<uint64_t> chunkHash;     // Walls and pellets of each chunk, to spot what a reload changed
+    unsigned frameCounter = 0;
+
+    // Single tiles that changed inside otherwise valid chunk textures (an eaten pellet, a
+    // power pellet blinking) are repainted on their own instead of redrawing the chunk.
+    // Sprites are never baked into the chunks, so moving them dirties nothing.
+    std::vector<int> dirtyTiles;         // Grid indices, may repeat
+    std::vector<int> powerPellets;       // Pellet indices, repainted on every blink
+    bool powerPelletsLit = true;
+    int dirtyTileCount = 0, redrawnChunkCount = 0; // Last refresh, for the overlay
+    bool showRedrawStats = false;        // O; always shown in swarm mode
+
+    FileWatcher levelWatcher;
+
+    // Snapshot ring buffer, allocated once. Levels too big to snapshot simply don't record.
+    std::vector<PacmanCore::Snapshot> history;
+    int historyHead = 0, historyCount = 0;
+    float rewindAccumulator = 0.0f;
+
+    // Every live game is recorded; P plays the recording back instead of the keyboard.
+    PacmanRecording recording;
+    PacmanRecording::Cursor replayCursor;
+    bool replaying = false;
+
+    // The autopilot searches on its own threads; Update() only hands it a time budget.
+    PacmanAutopilot autopilot;
+    bool autopilotEnabled = false;
+
+    Texture2D ghostSprite;
+    int swarmIndex = 0;
+    double updateMsTotal = 0.0, drawMsTotal = 0.0; // Per swarm size, reported when it changes
+    int timedFrames = 0;
+
+    // The core always advances in fixed ticks, so the game plays the same at 60 Hz, 144 Hz
+    // or during a frame hitch. Draw() interpolates between the last two ticks.
+    float tickAccumulator = 0.0f;
+    PacAction pendingAction = ACTION_NONE; // Latest key, held until a tick consumes it
 
-    struct Ghost {
-        Vector2 position, startPosition;
-        Vector2 direction = { -1, 0 };
-        GhostType type;
-        GhostState state = CHASING;
-        float stateTimer = 0.0f;
-        float speed = 2.0f;
-        float radius = TILE_SIZE / 2.0f - 2.0f;
-    };
+    bool mapLoaded = false;
+    std::string loadErrorText = "";
 
-    struct Pellet {
-        Vector2 position;
-        float radius;
-        bool active;
-        bool isPowerPellet = false;
-        int points;
-    };
+    // A pellet every few ticks would restart a single Sound constantly, so effects play from
+    // pools of voices with a per-sound rate limit.
+    SfxPool sfx;
+    int sfxChomp = -1, sfxEatGhost = -1, sfxDeath = -1, sfxStart = -1;
 
-    struct Wall {
-        Rectangle rect;
-    };
 
     //----------------------------------------------------------------------------------
-    // Game State and Asset Variables
+    // Private Module Functions
     //----------------------------------------------------------------------------------
 
-    std::vector<Wall> walls;
-    std::vector<Pellet> pellets;
-    std::vector<Ghost> ghosts;
-    Player player;
+    static Vector2 ToVector2(Vec2 v) { return { v.x, v.y }; }
 
-    int playerLives = 3;
-    int score = 0;
-    int activePellets = 0;
-    int mapWidth = 0, mapHeight = 0;
-    bool gameOver = false;
-    bool victory = false;
+    // Loads the current campaign level synchronously; only used when nothing is preloaded.
+    void LoadMap() {
+        const CampaignLevel& level = campaign[levelIndex];
+        double loadStart = GetTime();
+        if (!LoadCampaignLevel(level, game)) {
+            mapLoaded = false;
+            loadErrorText = "ERROR: " + level.source + " not found!";
+            TraceLog(LOG_ERROR, "Failed to open map file: %s", level.source.c_str());
+            return;
+        }
+        TraceLog(LOG_INFO, "PACMAN: Loaded level %d (%s) in %.2f ms (%s)", levelIndex + 1, level.source.c_str(),
+                 (GetTime() - loadStart) * 1000.0, game.WasLastLoadEmbedded() ? "embedded" : game.WasLastLoadCached() ? "compiled" : "parsed and cached");
+        OnMapLoaded();
+    }
 
-    RoundState roundState = READY;
-    float roundStateTimer = 2.0f;
-    int ghostsEatenThisPowerup = 0;
+    // Hot reload after the current level's file was saved. Only what is derived from the map
+    // is rebuilt (core tables, chunk lists, autopilot, recording); sounds and textures stay
+    // loaded, and cached chunk textures are kept wherever the walls and pellets didn't
+    // change. A file that fails to load leaves the current level playing.
+    void ReloadMap() {
+        const CampaignLevel& level = campaign[levelIndex];
+        double reloadStart = GetTime();
+        PacmanCore reloaded;
+        if (!LoadCampaignLevel(level, reloaded)) {
+            TraceLog(LOG_WARNING, "PACMAN: Reload of %s failed, keeping the current level", level.source.c_str());
+            return;
+        }
+        InvalidateEatenPelletChunks(); // The reset below brings those pellets back
+        game = std::move(reloaded);
+        int redrawn = OnMapLoaded();
+        SetSwarmSize(swarmIndex);
+        TraceLog(LOG_INFO, "PACMAN: Reloaded %s in %.2f ms, %d of %d chunks redrawn", level.source.c_str(),
+                 (GetTime() - reloadStart) * 1000.0, redrawn, chunksX * chunksY);
+    }
 
-    bool mapLoaded = false;
-    std::string loadErrorText = "";
+    //----------------------------------------------------------------------------------
+    // Campaign
+    //----------------------------------------------------------------------------------
 
-    Sound sndChomp;
-    Sound sndEatGhost;
-    Sound sndDeath;
-    Sound sndStart;
+    // Reads CAMPAIGN_FILE, or makes a one-level campaign of LEVEL_FILE at default speeds,
+    // and watches every level file it uses.
+    void LoadCampaignFile() {
+        if (!LoadCampaign(CAMPAIGN_FILE, campaign)) campaign = { CampaignLevel{ LEVEL_FILE, {} } };
+        levelIndex = std::min(levelIndex, (int)campaign.size() - 1);
+
+        levelWatcher.Clear();
+        levelWatcher.Watch(CAMPAIGN_FILE);
+        std::vector<std::string> watched;
+        for (const CampaignLevel& level : campaign) {
+            if (!IsCampaignFile(level.source)) continue;
+            if (std::find(watched.begin(), watched.end(), level.source) != watched.end()) continue;
+            levelWatcher.Watch(level.source);
+            watched.push_back(level.source);
+        }
+    }
 
+    int NextLevelIndex() const { return (levelIndex + 1) % (int)campaign.size(); }
+
+    void PreloadNextLevel() {
+        preloader.Request(campaign[NextLevelIndex()], NextLevelIndex());
+    }
+
+    void OnLevelFilesChanged(const std::vector<std::string>& changed) {
+        if (std::find(changed.begin(), changed.end(), CAMPAIGN_FILE) != changed.end()) {
+            LoadCampaignFile();
+            TraceLog(LOG_INFO, "PACMAN: %s changed, %d levels", CAMPAIGN_FILE, (int)campaign.size());
+            if (!useGeneratedMaze) ReloadMap(); // Its speeds may have changed
+            PreloadNextLevel();
+            return;
+        }
+        auto HasChanged = [&](const CampaignLevel& level) {
+            return std::find(changed.begin(), changed.end(), level.source) != changed.end();
+        };
+        if (HasChanged(campaign[levelIndex]) && !useGeneratedMaze) ReloadMap();
+        if (HasChanged(campaign[NextLevelIndex()])) PreloadNextLevel();
+    }
+
+    // Swaps in the preloaded next level. Lives and score carry over unless the campaign
+    // wrapped around. Until the preloader is done this does nothing and is called again
+    // next frame; a level that failed to load is skipped by replaying the current one.
+    void AdvanceLevel() {
+        int next = NextLevelIndex();
+        bool wrapped = next <= levelIndex;
+        int lives = wrapped ? 3 : game.GetLives(), score = wrapped ? 0 : game.GetScore();
+        if (preloader.HasFailed(next)) {
+            TraceLog(LOG_WARNING, "PACMAN: Level %d (%s) failed to load, replaying level %d", next + 1,
+                     campaign[next].source.c_str(), levelIndex + 1);
+            advancing = false;
+            ResetGame(lives, score);
+            PreloadNextLevel();
+            return;
+        }
+
+        double swapStart = GetTime();
+        InvalidateEatenPelletChunks(); // Before the swap, while the indices still mean the old pellets
+        if (!preloader.Take(next, game)) return;
+        levelIndex = next;
+        advancing = false;
+        int redrawn = OnMapLoaded();
+        game.SpawnGhostSwarm(SWARM_SIZES[swarmIndex], (unsigned)GetRandomValue(0, 1 << 30));
+        if (autopilotEnabled) SetAutopilot(true);
+        ResetGame(lives, score);
+        TraceLog(LOG_INFO, "PACMAN: Level %d (%s) swapped in after %.2f ms of background loading, swap %.2f ms, %d chunks redrawn",
+                 levelIndex + 1, campaign[levelIndex].source.c_str(), preloader.GetLastLoadMs(),
+                 (GetTime() - swapStart) * 1000.0, redrawn);
+        PreloadNextLevel();
+    }
+
+    void LoadGeneratedMap() {
+        double loadStart = GetTime();
+        if (!game.LoadLevelFromLines(GenerateMazeLines(GENERATED_MAZE_SIZE, GENERATED_MAZE_SIZE, (unsigned)GetRandomValue(0, 1 << 30)))) {
+            mapLoaded = false;
+            loadErrorText = "ERROR: maze generation failed!";
+            return;
+        }
+        TraceLog(LOG_INFO, "PACMAN: Generated %dx%d maze in %.2f ms", game.GetMapWidth(), game.GetMapHeight(),
+                 (GetTime() - loadStart) * 1000.0);
+        OnMapLoaded();
+    }
+
+    // Returns how many chunks need redrawing.
+    int OnMapLoaded() {
+        const TileDistanceTable& table = game.GetDistanceTable();
+        TraceLog(LOG_INFO, "PACMAN: Distance table for %d open tiles (%s) built in %.2f ms, %.1f KB",
+                 table.openCount, table.IsLazy() ? "lazy rows" : "full",
+                 table.buildMs, table.MemoryBytes() / 1024.0f);
+        const MazeAnalysis& maze = game.GetMazeAnalysis();
+        TraceLog(LOG_INFO, "PACMAN: Maze analysis in %.2f ms: %d junctions, %d corridors (longest %d tiles), %d tunnels",
+                 maze.buildMs, maze.junctionCount, (int)maze.segments.size(), maze.longestSegment, (int)maze.tunnels.size());
+        if (game.GetUnreachablePelletCount() > 0) {
+            TraceLog(LOG_WARNING, "PACMAN: %d pellets can't be reached from the player start and were left out",
+                     game.GetUnreachablePelletCount());
+        }
+
+        int redrawn = BuildChunks();
+        mapLoaded = true;
+        return redrawn;
+    }
 
     //----------------------------------------------------------------------------------
-    // Private Module Functions
+    // Chunks
     //----------------------------------------------------------------------------------
 
-    Vector2 WorldToTile(Vector2 worldPos) {
-        return { (float)floor(worldPos.x / TILE_SIZE), (float)floor(worldPos.y / TILE_SIZE) };
+    int ChunkOfTile(int x, int y) const {
+        int cx = std::clamp(x / CHUNK_TILES, 0, chunksX - 1);
+        int cy = std::clamp(y / CHUNK_TILES, 0, chunksY - 1);
+        return cy * chunksX + cx;
     }
 
-    bool IsWall(int x, int y) {
-        if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) return true;
-        for (const auto& wall : walls) {
-            if (CheckCollisionPointRec({(float)x * TILE_SIZE, (float)y * TILE_SIZE}, wall.rect)) {
-                return true;
+    // Groups pellet indices by chunk (counting sort), so a chunk redraw only visits its own pellets.
+    // If the chunk grid keeps its size (a reloaded level), only chunks whose walls or pellets
+    // changed lose their cached texture. Returns how many chunks need redrawing.
+    int BuildChunks() {
+        int oldChunksX = chunksX, oldChunksY = chunksY;
+        chunksX = (game.GetMapWidth() + CHUNK_TILES - 1) / CHUNK_TILES;
+        chunksY = (game.GetMapHeight() + CHUNK_TILES - 1) / CHUNK_TILES;
+        int chunkCount = chunksX * chunksY;
+
+        const auto& pellets = game.GetPellets();
+        std::vector<int> pelletChunk(pellets.Count());
+        chunkPelletStart.assign(chunkCount + 1, 0);
+        for (int i = 0; i < pellets.Count(); i++) {
+            Vec2 tile = PacmanCore::WorldToTile(pellets.position[i]);
+            pelletChunk[i] = ChunkOfTile((int)tile.x, (int)tile.y);
+            chunkPelletStart[pelletChunk[i] + 1]++;
+        }
+        for (int c = 0; c < chunkCount; c++) chunkPelletStart[c + 1] += chunkPelletStart[c];
+
+        chunkPellets.resize(pellets.Count());
+        std::vector<int> cursor(chunkPelletStart.begin(), chunkPelletStart.end() - 1);
+        for (int i = 0; i < pellets.Count(); i++) chunkPellets[cursor[pelletChunk[i]]++] = i;
+
+        dirtyTiles.clear(); // Grid indices of the old map
+        powerPellets.clear();
+        for (int i = 0; i < pellets.Count(); i++) {
+            if (pellets.isPowerPellet[i]) powerPellets.push_back(i);
+        }
+
+        std::vector<uint64_t> oldHash = std::move(chunkHash);
+        chunkHash.resize(chunkCount);
+        for (int c = 0; c < chunkCount; c++) chunkHash[c] = HashChunk(c);
+
+        if (chunksX != oldChunksX || chunksY != oldChunksY || (int)oldHash.size() != chunkCount) {
+            chunkVersion.assign(chunkCount, 0);
+            chunkSlot.assign(chunkCount, -1);
+            for (auto& entry : chunkCache) entry.chunk = -1;
+            return chunkCount;
+        }
+        int changed = 0;
+        for (int c = 0; c < chunkCount; c++) {
+            if (chunkHash[c] == oldHash[c]) continue;
+            chunkVersion[c]++;
+            changed++;
+        }
+        return changed;
+    }
+
+    uint64_t HashChunk(int chunk) const {
+        const TileGrid& grid = game.GetGrid();
+        int tileX0 = (chunk % chunksX) * CHUNK_TILES, tileY0 = (chunk / chunksX) * CHUNK_TILES;
+        int tileX1 = std::min(tileX0 + CHUNK_TILES, grid.width), tileY1 = std::min(tileY0 + CHUNK_TILES, grid.height);
+
+        uint64_t hash = HashBytes(&grid.width, sizeof(grid.width));
+        for (int y = tileY0; y < tileY1; y++) hash = HashBytes(&grid.walls[grid.Index(tileX0, y)], tileX1 - tileX0, hash);
+        const auto& pellets = game.GetPellets();
+        for (int i = chunkPelletStart[chunk]; i < chunkPelletStart[chunk + 1]; i++) {
+            int index = chunkPellets[i];
+            int32_t key[4] = { pellets.position[index].x, pellets.position[index].y, pellets.radius[index], game.IsPelletReachable(index) };
+            hash = HashBytes(key, sizeof(key), hash);
+        }
+        return hash;
+    }
+
+    // Chunks showing an eaten pellet, which a reset puts back.
+    void InvalidateEatenPelletChunks() {
+        for (int c = 0; c < (int)chunkVersion.size(); c++) {
+            for (int i = chunkPelletStart[c]; i < chunkPelletStart[c + 1]; i++) {
+                int index = chunkPellets[i];
+                if (game.IsPelletActive(index) || !game.IsPelletReachable(index)) continue;
+                chunkVersion[c]++;
+                break;
             }
         }
-        return false;
     }
 
-    void LoadMap(const char* fileName) {
-        walls.clear();
-        pellets.clear();
-        ghosts.clear();
-        mapWidth = 0;
-        mapHeight = 0;
+    void InvalidateAllChunks() {
+        for (auto& version : chunkVersion) version++;
+    }
 
-        std::ifstream file(fileName);
-        if (!file.is_open()) {
-            mapLoaded = false;
-            loadErrorText = "ERROR: level.txt not found!";
-            TraceLog(LOG_ERROR, "Failed to open map file: %s", fileName);
-            return;
+    // A pellet the player just ate lies in its 3x3 tile neighbourhood.
+    void MarkPelletTilesAroundPlayer() {
+        Vec2 tile = PacmanCore::WorldToTile(game.GetPlayer().position);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int x = (int)tile.x + dx, y = (int)tile.y + dy;
+                if (game.GetPelletAtTile(x, y) >= 0) dirtyTiles.push_back(game.GetGrid().Index(x, y));
+            }
+        }
+    }
+
+    bool IsPelletShown(int index) const {
+        return game.IsPelletActive(index) && (powerPelletsLit || !game.GetPellets().isPowerPellet[index]);
+    }
+
+    // Walls and pellets of one chunk, with the chunk's top-left corner at 'origin'.
+    void DrawChunkContents(int chunk, Vector2 origin) const {
+        const TileGrid& grid = game.GetGrid();
+        int tileX0 = (chunk % chunksX) * CHUNK_TILES, tileY0 = (chunk / chunksX) * CHUNK_TILES;
+        int tileX1 = std::min(tileX0 + CHUNK_TILES, grid.width), tileY1 = std::min(tileY0 + CHUNK_TILES, grid.height);
+
+        for (int y = tileY0; y < tileY1; y++) {
+            for (int x = tileX0; x < tileX1; x++) {
+                if (grid.IsWall(x, y)) DrawRectangleRec({ origin.x + (x - tileX0) * TILE_SIZE, origin.y + (y - tileY0) * TILE_SIZE, TILE_SIZE, TILE_SIZE }, DARKBLUE);
+            }
+        }
+
+        const auto& pellets = game.GetPellets();
+        Vector2 shift = { origin.x - tileX0 * TILE_SIZE, origin.y - tileY0 * TILE_SIZE };
+        for (int i = chunkPelletStart[chunk]; i < chunkPelletStart[chunk + 1]; i++) {
+            int index = chunkPellets[i];
+            if (IsPelletShown(index)) DrawCircleV(Vector2Add(ToVector2(PacmanCore::ToWorld(pellets.position[index])), shift), PacmanCore::ToPixels(pellets.radius[index]), YELLOW);
+        }
+    }
+
+    // Repaints one tile of a chunk texture whose top-left tile is (tileX0, tileY0). Painting
+    // the floor black rather than clearing it looks the same, since the screen behind the
+    // chunks is cleared to black.
+    void DrawTile(int x, int y, int tileX0, int tileY0) const {
+        Vector2 corner = { (x - tileX0) * TILE_SIZE, (y - tileY0) * TILE_SIZE };
+        DrawRectangleV(corner, { TILE_SIZE, TILE_SIZE }, game.GetGrid().IsWall(x, y) ? DARKBLUE : BLACK);
+        int index = game.GetPelletAtTile(x, y);
+        if (index < 0 || !IsPelletShown(index)) return;
+        const PacmanCore::PelletArrays& pellets = game.GetPellets();
+        Vector2 position = ToVector2(PacmanCore::ToWorld(pellets.position[index]));
+        DrawCircleV({ position.x - tileX0 * TILE_SIZE, position.y - tileY0 * TILE_SIZE }, PacmanCore::ToPixels(pellets.radius[index]), YELLOW);
+    }
+
+    // Applies dirtyTiles to the chunk textures, one texture mode per chunk. A dirty tile in a
+    // chunk that isn't cached or is stale anyway needs nothing; one in a cached chunk that is
+    // off screen marks the whole chunk stale, to be redrawn only if it comes back into view.
+    void RedrawDirtyTiles(int x0, int y0, int x1, int y1) {
+        const TileGrid& grid = game.GetGrid();
+        auto chunkOf = [&](int tile) { return ChunkOfTile(tile % grid.width, tile / grid.width); };
+        std::sort(dirtyTiles.begin(), dirtyTiles.end(), [&](int a, int b) {
+            int chunkA = chunkOf(a), chunkB = chunkOf(b);
+            return chunkA != chunkB ? chunkA < chunkB : a < b;
+        });
+        dirtyTiles.erase(std::unique(dirtyTiles.begin(), dirtyTiles.end()), dirtyTiles.end());
+        dirtyTileCount = (int)dirtyTiles.size();
+
+        int openChunk = -1;
+        for (int tile : dirtyTiles) {
+            int chunk = chunkOf(tile);
+            int slot = chunkSlot[chunk];
+            if (slot < 0 || chunkCache[slot].version != chunkVersion[chunk]) continue;
+            int cx = chunk % chunksX, cy = chunk / chunksX;
+            if (cx < x0 || cx > x1 || cy < y0 || cy > y1) {
+                chunkVersion[chunk]++;
+                continue;
+            }
+            if (chunk != openChunk) {
+                if (openChunk >= 0) EndTextureMode();
+                BeginTextureMode(chunkCache[slot].target);
+                openChunk = chunk;
+            }
+            DrawTile(tile % grid.width, tile / grid.width, cx * CHUNK_TILES, cy * CHUNK_TILES);
         }
+        if (openChunk >= 0) EndTextureMode();
+        dirtyTiles.clear();
+    }
 
-        std::string line;
-        int y = 0;
-        while (std::getline(file, line)) {
-            mapWidth = std::max(mapWidth, (int)line.length());
-            for (int x = 0; x < line.length(); ++x) {
-                Vector2 pos = { x * TILE_SIZE + TILE_SIZE / 2, y * TILE_SIZE + TILE_SIZE / 2 };
-                switch (line[x]) {
-                    case '#': walls.push_back({ { pos.x - TILE_SIZE/2, pos.y - TILE_SIZE/2, TILE_SIZE, TILE_SIZE } }); break;
-                    case '.': pellets.push_back({ pos, 2.0f, true, false, 10 }); break;
-                    case 'O': pellets.push_back({ pos, 6.0f, true, true, 50 }); break;
-                    case 'P': player.startPosition = pos; break;
-                    case 'G': ghosts.push_back({ pos, pos, {-1, 0}, (GhostType)(ghosts.size() % 4) }); break;
+    int AcquireChunkSlot() {
+        if ((int)chunkCache.size() < CHUNK_CACHE_SIZE) {
+            ChunkTexture entry;
+            entry.target = LoadRenderTexture((int)CHUNK_SIZE, (int)CHUNK_SIZE);
+            chunkCache.push_back(entry);
+            return (int)chunkCache.size() - 1;
+        }
+        int victim = 0;
+        for (int i = 1; i < (int)chunkCache.size(); i++) {
+            if (chunkCache[i].lastUsedFrame < chunkCache[victim].lastUsedFrame) victim = i;
+        }
+        if (chunkCache[victim].chunk >= 0) chunkSlot[chunkCache[victim].chunk] = -1;
+        return victim;
+    }
+
+    // Renders missing or stale visible chunks. Runs from Update() because raylib can't nest
+    // texture modes and Draw() already runs inside the CRT render target.
+    void RefreshVisibleChunks() {
+        frameCounter++;
+        int x0, y0, x1, y1;
+        VisibleChunks(CameraOffset(), x0, y0, x1, y1);
+
+        bool lit = std::fmod(GetTime(), 2.0 * POWER_PELLET_BLINK) < POWER_PELLET_BLINK;
+        if (lit != powerPelletsLit) {
+            powerPelletsLit = lit;
+            const auto& pellets = game.GetPellets();
+            for (int index : powerPellets) {
+                if (!game.IsPelletActive(index)) continue;
+                Vec2 tile = PacmanCore::WorldToTile(pellets.position[index]);
+                dirtyTiles.push_back(game.GetGrid().Index((int)tile.x, (int)tile.y));
+            }
+        }
+        RedrawDirtyTiles(x0, y0, x1, y1);
+
+        redrawnChunkCount = 0;
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int chunk = cy * chunksX + cx;
+                int slot = chunkSlot[chunk];
+                if (slot < 0) {
+                    slot = AcquireChunkSlot();
+                    chunkSlot[chunk] = slot;
+                    chunkCache[slot].chunk = chunk;
+                    chunkCache[slot].version = chunkVersion[chunk] - 1;
                 }
+                ChunkTexture& entry = chunkCache[slot];
+                entry.lastUsedFrame = frameCounter;
+                if (entry.version == chunkVersion[chunk]) continue;
+
+                BeginTextureMode(entry.target);
+                ClearBackground(BLANK);
+                DrawChunkContents(chunk, { 0, 0 });
+                EndTextureMode();
+                entry.version = chunkVersion[chunk];
+                redrawnChunkCount++;
             }
-            y++;
         }
-        mapHeight = y;
-        mapLoaded = true;
     }
 
-    void ResetGame() {
+    //----------------------------------------------------------------------------------
+    // Camera
+    //----------------------------------------------------------------------------------
+
+    // Centred when the map fits on screen (the classic maze), otherwise following 'focus'
+    // and clamped so the view never leaves the map.
+    static float CameraAxis(float mapSize, float screenSize, float focus) {
+        if (mapSize <= screenSize) return (screenSize - mapSize) / 2;
+        return std::clamp(screenSize / 2 - focus, screenSize - mapSize, 0.0f);
+    }
+
+    // World-to-screen offset, whole pixels so cached chunk textures stay crisp.
+    Vector2 CameraOffset() const {
+        const PacmanCore::Player& player = game.GetPlayer();
+        Vector2 focus = InterpolatedPosition(player.prevPosition, player.position);
+        return { std::floor(CameraAxis(game.GetMapWidth() * TILE_SIZE, (float)GetScreenWidth(), focus.x)),
+                 std::floor(CameraAxis(game.GetMapHeight() * TILE_SIZE, (float)GetScreenHeight(), focus.y)) };
+    }
+
+    void VisibleChunks(Vector2 offset, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = std::max(0, (int)std::floor(-offset.x / CHUNK_SIZE));
+        y0 = std::max(0, (int)std::floor(-offset.y / CHUNK_SIZE));
+        x1 = std::min(chunksX - 1, (int)std::floor((GetScreenWidth() - offset.x - 1) / CHUNK_SIZE));
+        y1 = std::min(chunksY - 1, (int)std::floor((GetScreenHeight() - offset.y - 1) / CHUNK_SIZE));
+    }
+
+    void SetSwarmSize(int index) {
+        if (timedFrames > 0) {
+            TraceLog(LOG_INFO, "PACMAN: %d ghosts: update %.3f ms, draw %.3f ms per frame (%d frames)",
+                     game.GetGhostCount(), updateMsTotal / timedFrames, drawMsTotal / timedFrames, timedFrames);
+        }
+        updateMsTotal = drawMsTotal = 0.0;
+        timedFrames = 0;
+
+        swarmIndex = index;
+        game.SpawnGhostSwarm(SWARM_SIZES[swarmIndex], (unsigned)GetRandomValue(0, 1 << 30));
+        if (autopilotEnabled) SetAutopilot(true); // Workers hold a copy of the old level
+        ResetGame();
+    }
+
+    void ResetGame(int lives = 3, int score = 0) {
         if (!mapLoaded) return;
-        
-        playerLives = 3;
-        score = 0;
-        gameOver = false;
-        victory = false;
-        
-        activePellets = 0;
-        for (auto& p : pellets) {
-            p.active = true;
-            activePellets++;
+        InvalidateEatenPelletChunks();
+        game.Reset(lives, score);
+        tickAccumulator = 0.0f;
+        pendingAction = ACTION_NONE;
+        historyCount = 0;
+        replaying = false;
+        recording.Begin(game);
+        autopilot.Restart();
+    }
+
+    void SetAutopilot(bool enabled) {
+        autopilotEnabled = enabled && autopilot.Start(game);
+        if (!autopilotEnabled) autopilot.Stop();
+        if (enabled && !autopilotEnabled) TraceLog(LOG_WARNING, "PACMAN: Autopilot needs a classic-size level");
+        autopilot.Restart();
+    }
+
+    void SaveRecording() {
+        if (recording.GetTickCount() == 0) return;
+        std::error_code error;
+        std::filesystem::create_directories("replays", error);
+        if (recording.Save(REPLAY_FILE)) {
+            TraceLog(LOG_INFO, "PACMAN: Saved %d ticks to %s (%d input bytes, %d keyframes)", recording.GetTickCount(),
+                     REPLAY_FILE, (int)recording.GetInputBytes(), recording.GetKeyframeCount());
         }
+    }
 
-        StartNewRound();
+    void StartReplay() {
+        recording.Finish();
+        SaveRecording();
+        replaying = recording.Seek(game, 0, replayCursor);
+        tickAccumulator = 0.0f;
+        InvalidateAllChunks();
     }
 
-    void StartNewRound() {
-        player.position = player.startPosition;
-        player.direction = {0, 0};
-        player.desiredDirection = {0, 0};
+    void SeekReplay(int tick) {
+        double seekStart = GetTime();
+        recording.Seek(game, tick, replayCursor);
+        TraceLog(LOG_INFO, "PACMAN: Seek to tick %d took %.2f ms", replayCursor.tick, (GetTime() - seekStart) * 1000.0);
+        tickAccumulator = 0.0f;
+        InvalidateAllChunks();
+    }
 
-        for (auto& ghost : ghosts) {
-            ghost.position = ghost.startPosition;
-            ghost.state = CHASING;
-            ghost.direction = {-1, 0};
+    // Plays the recording back at normal speed, with the same sounds as a live game.
+    void UpdateReplay() {
+        if (IsKeyPressed(KEY_LEFT_BRACKET)) SeekReplay(replayCursor.tick - REPLAY_SEEK_TICKS);
+        if (IsKeyPressed(KEY_RIGHT_BRACKET)) SeekReplay(replayCursor.tick + REPLAY_SEEK_TICKS);
+
+        tickAccumulator += std::min(GetFrameTime(), MAX_FRAME_TIME);
+        while (tickAccumulator >= TICK_DT) {
+            tickAccumulator -= TICK_DT;
+            if (replayCursor.tick >= recording.GetTickCount()) {
+                tickAccumulator = 0.0f;
+                break;
+            }
+            PacStepResult result = game.Step(recording.Next(replayCursor));
+            if (result.events & EVENT_PELLET) MarkPelletTilesAroundPlayer();
+            PlayStepSounds(result);
         }
-        
-        roundState = READY;
-        roundStateTimer = 2.0f;
+        RefreshVisibleChunks();
+    }
+
+    void PlayStepSounds(const PacStepResult& result) {
+        if (result.events & EVENT_PELLET) sfx.Play(sfxChomp);
+        if (result.events & EVENT_GHOST_EATEN) sfx.Play(sfxEatGhost);
+        if (result.events & EVENT_PLAYER_DIED) sfx.Play(sfxDeath);
+    }
+
+    void RecordSnapshot() {
+        if (!game.SaveSnapshot(history[historyHead])) return;
+        historyHead = (historyHead + 1) % REWIND_TICKS;
+        historyCount = std::min(historyCount + 1, REWIND_TICKS);
     }
 
-    void ResetAfterLifeLost() {
-        player.position = player.startPosition;
-        player.direction = {0, 0};
-        player.desiredDirection = {0, 0};
-        for (auto& ghost : ghosts) {
-            ghost.position = ghost.startPosition;
-            ghost.state = CHASING;
-            ghost.direction = {-1, 0};
+    // Steps back through the history at normal speed while R is held.
+    void Rewind() {
+        rewindAccumulator += std::min(GetFrameTime(), MAX_FRAME_TIME);
+        while (rewindAccumulator >= TICK_DT && historyCount > 0) {
+            rewindAccumulator -= TICK_DT;
+            historyHead = (historyHead + REWIND_TICKS - 1) % REWIND_TICKS;
+            historyCount--;
+
+            int pelletsBefore = game.GetActivePellets();
+            game.RestoreSnapshot(history[historyHead]);
+            recording.TruncateTo(recording.GetTickCount() - 1);
+            autopilot.Restart();
+            if (game.GetActivePellets() != pelletsBefore) InvalidateAllChunks();
         }
-        roundState = READY;
-        roundStateTimer = 2.0f;
+        tickAccumulator = 0.0f; // Draw exactly the restored tick
+        pendingAction = ACTION_NONE;
+    }
+
+    Vector2 InterpolatedPosition(FixVec2 prevPosition, FixVec2 position) const {
+        if (FixManhattan(prevPosition, position) > PacmanCore::TILE_UNITS) return ToVector2(PacmanCore::ToWorld(position));
+        return Vector2Lerp(ToVector2(PacmanCore::ToWorld(prevPosition)), ToVector2(PacmanCore::ToWorld(position)), tickAccumulator / TICK_DT);
     }
 
 public:
     PacmanChannel() {
-        LoadMap("level.txt");
-        sndChomp = LoadSound("assets/chomp.wav");
-        sndEatGhost = LoadSound("assets/eatghost.wav");
-        sndDeath = LoadSound("assets/death.wav");
-        sndStart = LoadSound("assets/start.wav");
+        history.resize(REWIND_TICKS);
+        LoadCampaignFile();
+        LoadMap();
+        PreloadNextLevel();
+        sfxChomp = sfx.Load("assets/chomp.wav", 4, 0.05f);
+        sfxEatGhost = sfx.Load("assets/eatghost.wav", 2, 0.1f);
+        sfxDeath = sfx.Load("assets/death.wav", 1, 0.5f);
+        sfxStart = sfx.Load("assets/start.wav", 1, 0.0f);
+
+        Image sprite = GenImageColor(GHOST_SPRITE_SIZE, GHOST_SPRITE_SIZE, BLANK);
+        ImageDrawCircle(&sprite, GHOST_SPRITE_SIZE / 2, GHOST_SPRITE_SIZE / 2, GHOST_SPRITE_SIZE / 2 - 1, WHITE);
+        ghostSprite = LoadTextureFromImage(sprite);
+        SetTextureFilter(ghostSprite, TEXTURE_FILTER_BILINEAR);
+        UnloadImage(sprite);
+
         ResetGame();
     }
 
     const char* GetName() const override { return "Pac-Man"; }
 
     ~PacmanChannel() {
-        UnloadSound(sndChomp);
-        UnloadSound(sndEatGhost);
-        UnloadSound(sndDeath);
-        UnloadSound(sndStart);
+        for (auto& entry : chunkCache) UnloadRenderTexture(entry.target);
+        UnloadTexture(ghostSprite);
+        sfx.Unload();
+        preloader.Stop();
     }
 
     void OnEnter() override {
         ResetGame();
-        PlaySound(sndStart);
+        sfx.Play(sfxStart);
     }
 
     void OnExit() override {
-        if (IsSoundPlaying(sndStart)) {
-            StopSound(sndStart);
-        }
+        sfx.Stop(sfxStart);
+        TraceLog(LOG_INFO, "PACMAN: SFX %d voices, %lld triggers dropped by rate limits, %lld voices stolen",
+                 sfx.GetVoiceCount(), sfx.GetDroppedTriggers(), sfx.GetStolenVoices());
     }   
 
     void Update() override {
-        if (!mapLoaded || gameOver || victory) {
-            if (IsKeyPressed(KEY_ENTER)) ResetGame();
-            return;
+        std::vector<std::string> changedFiles = levelWatcher.Poll();
+        if (!changedFiles.empty()) OnLevelFilesChanged(changedFiles);
+
+        if (IsKeyPressed(KEY_M)) {
+            timedFrames = 0; // Timings for the old map aren't worth reporting
+            useGeneratedMaze = !useGeneratedMaze;
+            if (useGeneratedMaze) LoadGeneratedMap();
+            else LoadMap();
+            advancing = false;
+            SetSwarmSize(swarmIndex);
         }
+        if (IsKeyPressed(KEY_G) && mapLoaded) SetSwarmSize((swarmIndex + 1) % SWARM_SIZE_COUNT);
+        if (IsKeyPressed(KEY_O)) showRedrawStats = !showRedrawStats;
 
-        if (roundState == READY || roundState == PLAYING) {
-            if (IsKeyDown(KEY_D)) player.desiredDirection = { 1.0f, 0.0f };
-            else if (IsKeyDown(KEY_A)) player.desiredDirection = { -1.0f, 0.0f };
-            else if (IsKeyDown(KEY_W)) player.desiredDirection = { 0.0f, -1.0f };
-            else if (IsKeyDown(KEY_S)) player.desiredDirection = { 0.0f, 1.0f };
-
-            Vector2 playerTile = WorldToTile(player.position);
-            Vector2 playerTileCenter = { playerTile.x * TILE_SIZE + TILE_SIZE / 2, playerTile.y * TILE_SIZE + TILE_SIZE / 2 };
-
-            Vector2 nextTileDesired = Vector2Add(playerTile, player.desiredDirection);
-            if (!IsWall(nextTileDesired.x, nextTileDesired.y)) {
-                bool isOpposite = (player.desiredDirection.x == -player.direction.x && player.desiredDirection.y == -player.direction.y);
-                if (isOpposite || (player.desiredDirection.x != player.direction.x || player.desiredDirection.y != player.direction.y)) {
-                    if (Vector2Distance(player.position, playerTileCenter) < player.speed) {
-                        player.position = playerTileCenter;
-                        player.direction = player.desiredDirection;
-                    }
-                }
-            }
-
-            Vector2 nextTileCurrent = Vector2Add(playerTile, player.direction);
-            if (IsWall(nextTileCurrent.x, nextTileCurrent.y)) {
-                if (Vector2Distance(player.position, playerTileCenter) < player.speed) {
-                    player.position = playerTileCenter;
-                    player.direction = { 0, 0 };
-                }
-            }
-            
-            player.position = Vector2Add(player.position, Vector2Scale(player.direction, player.speed));
-
-            if (player.position.x < -TILE_SIZE/2) player.position.x = mapWidth * TILE_SIZE + TILE_SIZE/2;
-            if (player.position.x > mapWidth * TILE_SIZE + TILE_SIZE/2) player.position.x = -TILE_SIZE/2;
+        if (IsKeyPressed(KEY_P) && mapLoaded) {
+            if (replaying) ResetGame();
+            else StartReplay();
         }
+        if (replaying) {
+            UpdateReplay();
+            return;
+        }
+        if (IsKeyPressed(KEY_I) && mapLoaded) SetAutopilot(!autopilotEnabled);
 
+        if (mapLoaded && IsKeyDown(KEY_R) && historyCount > 0) {
+            Rewind();
+            RefreshVisibleChunks();
+            return;
+        }
+        rewindAccumulator = 0.0f;
 
-        switch(roundState) {
-            case READY: {
-                if (Vector2LengthSqr(player.direction) > 0) {
-                    roundState = PLAYING;
-                }
-            } break;
-
-            case PLAYER_DYING: {
-                roundStateTimer -= GetFrameTime();
-                if (roundStateTimer <= 0) {
-                    if (playerLives <= 0) {
-                        gameOver = true;
-                    } else {
-                        ResetAfterLifeLost();
-                    }
-                }
-            } break;
-
-            case PLAYING: {
-                for (auto& ghost : ghosts) {
-                    if (ghost.state != CHASING) {
-                        ghost.stateTimer -= GetFrameTime();
-                        if (ghost.stateTimer <= 0) {
-                            ghost.state = CHASING;
-                            ghost.speed = 2.0f;
-                        }
-                    }
-
-                    Vector2 ghostTile = WorldToTile(ghost.position);
-                    Vector2 ghostTileCenter = { ghostTile.x * TILE_SIZE + TILE_SIZE / 2, ghostTile.y * TILE_SIZE + TILE_SIZE / 2 };
-                    
-                    if (Vector2Distance(ghost.position, ghostTileCenter) < ghost.speed) {
-                        ghost.position = ghostTileCenter;
-                        float min_dist = 10000.0f;
-                        Vector2 best_dir = {0,0};
-                        std::vector<Vector2> possible_dirs = {{0,-1}, {0,1}, {-1,0}, {1,0}};
-                        Vector2 oppositeDir = Vector2Scale(ghost.direction, -1);
-
-                        for(const auto& dir : possible_dirs) {
-                            if (dir.x == oppositeDir.x && dir.y == oppositeDir.y) continue;
-                            Vector2 nextTile = Vector2Add(ghostTile, dir);
-                            if (!IsWall(nextTile.x, nextTile.y)) {
-                                float dist = Vector2Distance(nextTile, WorldToTile(player.position));
-                                if (dist < min_dist) {
-                                    min_dist = dist;
-                                    best_dir = dir;
-                                }
-                            }
-                        }
-                        if (best_dir.x != 0 || best_dir.y != 0) ghost.direction = best_dir;
-                    }
-                    ghost.position = Vector2Add(ghost.position, Vector2Scale(ghost.direction, ghost.speed));
-                }
-
-                for (auto& p : pellets) {
-                    if (p.active && CheckCollisionCircles(player.position, player.radius, p.position, p.radius)) {
-                        p.active = false;
-                        score += p.points;
-                        activePellets--;
-                        PlaySound(sndChomp);
-                        if (p.isPowerPellet) {
-                            ghostsEatenThisPowerup = 0;
-                            for (auto& ghost : ghosts) {
-                                if (ghost.state != EATEN) {
-                                    ghost.state = FRIGHTENED;
-                                    ghost.stateTimer = 7.0f;
-                                    ghost.speed = 1.5f;
-                                }
-                            }
-                        }
-                    }
-                }
-
-                for (auto& ghost : ghosts) {
-                    if (CheckCollisionCircles(player.position, player.radius, ghost.position, ghost.radius)) {
-                        if (ghost.state == CHASING) {
-                            playerLives--;
-                            roundState = PLAYER_DYING;
-                            roundStateTimer = 1.5f;
-                            PlaySound(sndDeath);
-                        } else if (ghost.state == FRIGHTENED) {
-                            ghostsEatenThisPowerup++;
-                            score += 100 * (int)pow(2, ghostsEatenThisPowerup);
-                            ghost.state = EATEN;
-                            ghost.position = ghost.startPosition;
-                            ghost.stateTimer = 3.0f;
-                            PlaySound(sndEatGhost);
-                        }
-                    }
-                }
+        // Cleared levels move on by themselves; the last one waits for ENTER to start over.
+        if (mapLoaded && game.IsVictory() && !useGeneratedMaze) {
+            if (NextLevelIndex() > levelIndex || IsKeyPressed(KEY_ENTER)) advancing = true;
+            if (advancing) AdvanceLevel();
+        }
+        if (!mapLoaded || game.IsFinished()) {
+            if (IsKeyPressed(KEY_ENTER) && !advancing) ResetGame();
+            if (mapLoaded) RefreshVisibleChunks();
+            return;
+        }
 
-                if (activePellets <= 0) {
-                     victory = true;
-                     StartNewRound();
-                }
-            } break;
+        double updateStart = GetTime();
+        if (IsKeyDown(KEY_D)) pendingAction = ACTION_RIGHT;
+        else if (IsKeyDown(KEY_A)) pendingAction = ACTION_LEFT;
+        else if (IsKeyDown(KEY_W)) pendingAction = ACTION_UP;
+        else if (IsKeyDown(KEY_S)) pendingAction = ACTION_DOWN;
+
+        tickAccumulator += std::min(GetFrameTime(), MAX_FRAME_TIME);
+        while (tickAccumulator >= TICK_DT) {
+            tickAccumulator -= TICK_DT;
+
+            PacAction action = autopilotEnabled ? autopilot.NextAction(game) : pendingAction;
+            RecordSnapshot();
+            recording.Record(game, action);
+            PacStepResult result = game.Step(action);
+            pendingAction = ACTION_NONE;
+            if (result.events & EVENT_PELLET) MarkPelletTilesAroundPlayer();
+            PlayStepSounds(result);
+
+            if (result.done) {
+                SaveRecording();
+                tickAccumulator = 0.0f;
+                break;
+            }
         }
+        if (autopilotEnabled) autopilot.Think(AUTOPILOT_BUDGET);
+        RefreshVisibleChunks();
+        updateMsTotal += (GetTime() - updateStart) * 1000.0;
     }
 
     void Draw() override {
@@ -405,56 +820,112 @@ public:
             return;
         }
 
-        float gameWidth = mapWidth * TILE_SIZE;
-        float gameHeight = mapHeight * TILE_SIZE;
-        Vector2 offset = { (GetScreenWidth() - gameWidth) / 2, (GetScreenHeight() - gameHeight) / 2 };
-        
-        for (const auto& wall : walls) DrawRectangleRec({wall.rect.x + offset.x, wall.rect.y + offset.y, wall.rect.width, wall.rect.height}, DARKBLUE);
-        for (const auto& pellet : pellets) if (pellet.active) DrawCircleV(Vector2Add(pellet.position, offset), pellet.radius, YELLOW);
+        double drawStart = GetTime();
+        Vector2 offset = CameraOffset();
+
+        // Cached texture when it's up to date, otherwise straight from the map (e.g. the
+        // first frame after switching channel, before Update() has run)
+        int x0, y0, x1, y1;
+        VisibleChunks(offset, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int chunk = cy * chunksX + cx;
+                Vector2 origin = { offset.x + cx * CHUNK_SIZE, offset.y + cy * CHUNK_SIZE };
+                int slot = chunkSlot[chunk];
+                if (slot >= 0 && chunkCache[slot].version == chunkVersion[chunk]) {
+                    const Texture2D& texture = chunkCache[slot].target.texture;
+                    DrawTextureRec(texture, { 0, 0, (float)texture.width, -(float)texture.height }, origin, WHITE);
+                } else {
+                    DrawChunkContents(chunk, origin);
+                }
+            }
+        }
+
+        const PacmanCore::GhostArrays& ghosts = game.GetGhosts();
+        const Rectangle spriteSource = { 0, 0, (float)ghostSprite.width, (float)ghostSprite.height };
+        for (int g = 0; g < ghosts.Count(); g++) {
+            Vector2 ghostDrawPos = Vector2Add(InterpolatedPosition(ghosts.prevPosition[g], ghosts.position[g]), offset);
+            if (ghostDrawPos.x < -TILE_SIZE || ghostDrawPos.y < -TILE_SIZE ||
+                ghostDrawPos.x > GetScreenWidth() + TILE_SIZE || ghostDrawPos.y > GetScreenHeight() + TILE_SIZE) continue;
 
-        for (const auto& ghost : ghosts) {
             Color ghostColor = WHITE;
-            float ghostRadius = ghost.radius;
+            float ghostRadius = PacmanCore::ToPixels(PacmanCore::GHOST_RADIUS);
 
             // --- FIX: Draw eaten ghosts as smaller white "eyes" ---
-            if (ghost.state == EATEN) {
+            if (ghosts.state[g] == PacmanCore::EATEN) {
                 ghostColor = WHITE;
-                ghostRadius = ghost.radius / 2.0f;
-            } else if (ghost.state == FRIGHTENED) {
-                ghostColor = (ghost.stateTimer < 3.0f && (int)(ghost.stateTimer * 5) % 2 == 0) ? WHITE : DARKBLUE;
+                ghostRadius /= 2.0f;
+            } else if (ghosts.state[g] == PacmanCore::FRIGHTENED) {
+                float stateTimer = ghosts.stateTicks[g] * TICK_DT;
+                ghostColor = (stateTimer < 3.0f && (int)(stateTimer * 5) % 2 == 0) ? WHITE : DARKBLUE;
             } else {
-                switch(ghost.type) {
-                    case BLINKY: ghostColor = RED; break;
-                    case PINKY:  ghostColor = PINK; break;
-                    case INKY:   ghostColor = SKYBLUE; break;
-                    case CLYDE:  ghostColor = ORANGE; break;
+                switch(ghosts.type[g]) {
+                    case PacmanCore::BLINKY: ghostColor = RED; break;
+                    case PacmanCore::PINKY:  ghostColor = PINK; break;
+                    case PacmanCore::INKY:   ghostColor = SKYBLUE; break;
+                    case PacmanCore::CLYDE:  ghostColor = ORANGE; break;
                 }
             }
-            DrawCircleV(Vector2Add(ghost.position, offset), ghostRadius, ghostColor);
+            Rectangle dest = { ghostDrawPos.x - ghostRadius, ghostDrawPos.y - ghostRadius, ghostRadius * 2, ghostRadius * 2 };
+            DrawTexturePro(ghostSprite, spriteSource, dest, { 0, 0 }, 0.0f, ghostColor);
         }
 
-        if (roundState == PLAYER_DYING) {
-            float deathProgress = (1.5f - roundStateTimer) / 1.5f;
-            DrawCircleV(Vector2Add(player.position, offset), player.radius * (1.0f - deathProgress), YELLOW);
+        const PacmanCore::Player& player = game.GetPlayer();
+        Vector2 playerDrawPos = Vector2Add(InterpolatedPosition(player.prevPosition, player.position), offset);
+        if (game.GetRoundState() == PacmanCore::PLAYER_DYING) {
+            float deathProgress = 1.0f - (float)game.GetRoundStateTicks() / PacmanCore::DYING_TICKS;
+            DrawCircleV(playerDrawPos, PacmanCore::ToPixels(player.radius) * (1.0f - deathProgress), YELLOW);
         } else {
-            DrawCircleV(Vector2Add(player.position, offset), player.radius, YELLOW);
+            DrawCircleV(playerDrawPos, PacmanCore::ToPixels(player.radius), YELLOW);
+        }
+
+        // Overlay lines stack down from the top-left corner, whichever of them are on
+        int overlayY = 10;
+        if (SWARM_SIZES[swarmIndex] > 0) {
+            drawMsTotal += (GetTime() - drawStart) * 1000.0;
+            timedFrames++;
+            DrawText(TextFormat("GHOSTS: %d  UPDATE: %.2f ms  DRAW: %.2f ms", game.GetGhostCount(),
+                                updateMsTotal / timedFrames, drawMsTotal / timedFrames), 10, overlayY, 20, LIME);
+            overlayY += OVERLAY_LINE_HEIGHT;
+            DrawText(TextFormat("SFX: %d/%d VOICES  %lld DROPPED  %lld STOLEN", sfx.GetActiveVoices(), sfx.GetVoiceCount(),
+                                sfx.GetDroppedTriggers(), sfx.GetStolenVoices()), 10, overlayY, 20, LIME);
+            overlayY += OVERLAY_LINE_HEIGHT;
+        }
+        if (showRedrawStats || SWARM_SIZES[swarmIndex] > 0) {
+            DrawText(TextFormat("REDRAW: %d DIRTY TILES  %d CHUNKS", dirtyTileCount, redrawnChunkCount), 10, overlayY, 20, LIME);
+            overlayY += OVERLAY_LINE_HEIGHT;
         }
 
-        DrawText(TextFormat("SCORE: %04i", score), 290, 265, 20, LIME);
-        for (int i = 0; i < playerLives; i++) {
+        if (autopilotEnabled) {
+            DrawText(TextFormat("AUTOPILOT: %d THREADS  %.0f ROLLOUTS/S  TABLE HITS %.0f%%", autopilot.GetThreadCount(),
+                                autopilot.GetRolloutsPerSecond(), autopilot.GetTranspositionHitRate() * 100.0), 10, overlayY, 20, SKYBLUE);
+            overlayY += OVERLAY_LINE_HEIGHT;
+        }
+        if (replaying) {
+            int tick = replayCursor.tick, total = recording.GetTickCount();
+            DrawText(TextFormat("REPLAY %d:%02d / %d:%02d   [ ] SEEK   P EXIT", tick / 3600, tick / 60 % 60,
+                                total / 3600, total / 60 % 60), 10, GetScreenHeight() - 30, 20, SKYBLUE);
+        }
+
+        DrawText(TextFormat("SCORE: %04i", game.GetScore()), 290, 265, 20, LIME);
+        if (!useGeneratedMaze) {
+            const char* levelText = TextFormat("LEVEL %d/%d", levelIndex + 1, (int)campaign.size());
+            DrawText(levelText, GetScreenWidth() / 2 - MeasureText(levelText, 20) / 2, 265, 20, LIME);
+        }
+        for (int i = 0; i < game.GetLives(); i++) {
             DrawCircle(GetScreenWidth() - 390.0f + (i * TILE_SIZE), 275, TILE_SIZE/2 - 2, YELLOW);
         }
 
-        if (roundState == READY) {
+        if (game.GetRoundState() == PacmanCore::READY) {
              DrawText("READY!", GetScreenWidth()/2 - MeasureText("READY!", 40)/2, GetScreenHeight()/2 - 40, 40, YELLOW);
              DrawText("Use WASD to Move", GetScreenWidth()/2 - MeasureText("Use WASD to Move", 20)/2, GetScreenHeight()/2 + 10, 20, GRAY);
         }
 
-        if (gameOver) {
+        if (game.IsGameOver()) {
             DrawText("GAME OVER", GetScreenWidth() / 2 - MeasureText("GAME OVER", 40) / 2, GetScreenHeight() / 2 - 40, 40, RED);
             DrawText("Press [ENTER] to Restart", GetScreenWidth() / 2 - MeasureText("Press [ENTER] to Restart", 20) / 2, GetScreenHeight() / 2 + 10, 20, GRAY);
         }
-        if (victory) {
+        if (game.IsVictory() && !advancing) {
             DrawText("VICTORY!", GetScreenWidth() / 2 - MeasureText("VICTORY!", 40) / 2, GetScreenHeight() / 2 - 40, 40, GOLD);
             DrawText("Press [ENTER] to Restart", GetScreenWidth() / 2 - MeasureText("Press [ENTER] to Restart", 20) / 2, GetScreenHeight() / 2 + 10, 20, GRAY);
         }
@@ -462,51 +933,121 @@ public:
 };
 
 // ---------- PongChannel ----------
+// The rules live in PongCore (pong_core.h), and chaos mode's in PongChaos (pong_chaos.h);
+// the channel feeds them the keys, runs their fixed ticks and draws them.
 class PongChannel : public IChannel {
 private:
-    enum GameState {
-        PLAYING,
-        GAME_OVER
-    };
+    PongCore game{ (float)screenWidth, (float)screenHeight };
+    int aiLevel = PONG_AI_NORMAL; // The right paddle's PONG_AI_LEVELS entry; see pong_ai.h
+
+    // Chaos mode: thousands of balls instead of the game, drawn as quads of one sprite texture
+    // rather than a DrawCircle (and its triangle fan) per ball. The quads go out in rlBegin/rlEnd
+    // chunks of MAX_QUADS_PER_BATCH, each of which may flush rlgl's batch buffer
+    static constexpr int CHAOS_SIZES[] = { 0, 256, 1024, 4096 };
+    static constexpr int CHAOS_SIZE_COUNT = sizeof(CHAOS_SIZES) / sizeof(CHAOS_SIZES[0]);
+    static constexpr int BALL_SPRITE_SIZE = 16;
+    static constexpr int MAX_QUADS_PER_BATCH = 1024; // Below rlgl's smallest (GLES2) batch buffer
+    PongChaos chaos{ (float)screenWidth, (float)screenHeight };
+    int chaosIndex = 0;
+    Texture2D ballSprite;
+    double stepMsTotal = 0.0, drawMsTotal = 0.0; // Per chaos size, reported when it changes
+    int timedFrames = 0;
+
+    // Physics runs in fixed ticks, so play doesn't depend on the frame rate; Draw()
+    // interpolates between the last two. A frame never runs more than MAX_TICKS_PER_FRAME
+    // ticks, so a slow machine drops time instead of falling ever further behind.
+    static constexpr float TICK_DT = PongCore::TICK_DT;
+    static constexpr int MAX_TICKS_PER_FRAME = 16;
+    float tickAccumulator = 0.0f;
+    float prevPlayerY = 0.0f, prevAiY = 0.0f;
+    Vector2 prevBallPosition = { 0.0f, 0.0f };
+
+    static Rectangle ToRectangle(const PongBox& box) { return { box.x, box.y, box.width, box.height }; }
 
-    // Game Objects
-    Rectangle player;
-    Rectangle ai;
-    Vector2 ballPosition;
-    Vector2 ballSpeed;
+    void ResetGame() {
+        game.Reset((unsigned)GetRandomValue(0, 0x7fffffff));
+        game.SetAi(PongCore::RIGHT, &PONG_AI_LEVELS[aiLevel]);
+        chaos.Reset(CHAOS_SIZES[chaosIndex], (unsigned)GetRandomValue(0, 0x7fffffff));
+        tickAccumulator = 0.0f;
+        SavePrevious();
+    }
 
-    // Game Properties
-    const float playerSpeed = 500.0f;
-    const float aiSpeed = 350.0f;
-    const float initialBallSpeed = 350.0f;
-    const float ballRadius = 8.0f;
+    void SetChaosSize(int index) {
+        if (timedFrames > 0) {
+            TraceLog(LOG_INFO, "PONG: %d balls%s: step %.3f ms, draw %.3f ms per frame (%d frames)", chaos.GetBallCount(),
+                     chaos.GetBallCollisions() ? " with collisions" : "", stepMsTotal / timedFrames, drawMsTotal / timedFrames, timedFrames);
+        }
+        stepMsTotal = drawMsTotal = 0.0;
+        timedFrames = 0;
 
-    // Game State Variables
-    int playerScore;
-    int aiScore;
-    const int winningScore = 3;
-    GameState currentState;
-    const char* winnerText;
+        chaosIndex = index;
+        ResetGame();
+    }
 
+    void UpdateChaos(PongAction action) {
+        double stepStart = GetTime();
+        tickAccumulator += GetFrameTime();
+        int ticks = 0;
+        while (tickAccumulator >= TICK_DT) {
+            tickAccumulator -= TICK_DT;
+            SavePrevious();
+            chaos.Step(action);
+            if (++ticks == MAX_TICKS_PER_FRAME) {
+                tickAccumulator = 0.0f;
+                break;
+            }
+        }
+        stepMsTotal += (GetTime() - stepStart) * 1000.0;
+    }
 
-    void ResetGame() {
-        player = { 30.0f, screenHeight / 2.0f - 50.0f, 10.0f, 100.0f };
-        ai = { screenWidth - 40.0f, screenHeight / 2.0f - 50.0f, 10.0f, 100.0f };
-        ballPosition = { screenWidth / 2.0f, screenHeight / 2.0f };
-        ballSpeed = { initialBallSpeed, initialBallSpeed };
+    // Every ball as a quad of the sprite, flushed in MAX_QUADS_PER_BATCH chunks
+    void DrawChaosBalls(float alpha) {
+        const float r = PongChaos::BALL_RADIUS;
+        int count = chaos.GetBallCount();
+        for (int begin = 0; begin < count; begin += MAX_QUADS_PER_BATCH) {
+            int end = std::min(count, begin + MAX_QUADS_PER_BATCH);
+            rlCheckRenderBatchLimit(4 * (end - begin));
+            rlSetTexture(ballSprite.id);
+            rlBegin(RL_QUADS);
+            rlColor4ub(GREEN.r, GREEN.g, GREEN.b, GREEN.a);
+            for (int i = begin; i < end; i++) {
+                float x = Lerp(chaos.prevX[i], chaos.x[i], alpha), y = Lerp(chaos.prevY[i], chaos.y[i], alpha);
+                rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x - r, y - r);
+                rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x - r, y + r);
+                rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + r, y + r);
+                rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + r, y - r);
+            }
+            rlEnd();
+            rlSetTexture(0);
+        }
+    }
+
+    bool ChaosActive() const { return CHAOS_SIZES[chaosIndex] > 0; }
+
+    const PongBox& GetPaddle(PongCore::Side side) const { return ChaosActive() ? chaos.GetPaddle(side) : game.GetPaddle(side); }
 
-        playerScore = 0;
-        aiScore = 0;
-        winnerText = "";
-        currentState = PLAYING;
+    void SavePrevious() {
+        prevPlayerY = GetPaddle(PongCore::LEFT).y;
+        prevAiY = GetPaddle(PongCore::RIGHT).y;
+        prevBallPosition = { game.GetBall().position.x, game.GetBall().position.y };
     }
 
 public:
 
     PongChannel() {
+        Image sprite = GenImageColor(BALL_SPRITE_SIZE, BALL_SPRITE_SIZE, BLANK);
+        ImageDrawCircle(&sprite, BALL_SPRITE_SIZE / 2, BALL_SPRITE_SIZE / 2, BALL_SPRITE_SIZE / 2 - 1, WHITE);
+        ballSprite = LoadTextureFromImage(sprite);
+        SetTextureFilter(ballSprite, TEXTURE_FILTER_BILINEAR);
+        UnloadImage(sprite);
+
         ResetGame();
     }
 
+    ~PongChannel() {
+        UnloadTexture(ballSprite);
+    }
+
     void OnEnter() override {
         ResetGame(); // Restart the game every time you switch to this channel
     }
@@ -515,75 +1056,43 @@ public:
 
     // Update contains all the game logic
     void Update() override {
-        switch (currentState) {
-            case PLAYING: {
-                // Player paddle movement
-                if (IsKeyDown(KEY_W) && player.y > 0) {
-                    player.y -= playerSpeed * GetFrameTime();
-                }
-                if (IsKeyDown(KEY_S) && player.y < screenHeight - player.height) {
-                    player.y += playerSpeed * GetFrameTime();
-                }
-
-                // AI paddle movement
-                if (ai.y + ai.height / 2 < ballPosition.y) ai.y += aiSpeed * GetFrameTime();
-                if (ai.y + ai.height / 2 > ballPosition.y) ai.y -= aiSpeed * GetFrameTime();
-                if (ai.y < 0) ai.y = 0;
-                if (ai.y > screenHeight - ai.height) ai.y = screenHeight - ai.height;
-
-                // Move the ball
-                ballPosition.x += ballSpeed.x * GetFrameTime();
-                ballPosition.y += ballSpeed.y * GetFrameTime();
-
-                // Ball collision: Top and bottom walls
-                if (ballPosition.y + ballRadius >= screenHeight || ballPosition.y - ballRadius <= 0) {
-                    ballSpeed.y *= -1;
-                }
-
-                // Ball collision: Paddles
-                if (CheckCollisionCircleRec(ballPosition, ballRadius, player) && ballSpeed.x < 0) {
-                    ballSpeed.x *= -1.1f;
-                    ballSpeed.y = (ballPosition.y - (player.y + player.height / 2)) / (player.height / 2) * std::fabs(ballSpeed.x);
-                }
-                if (CheckCollisionCircleRec(ballPosition, ballRadius, ai) && ballSpeed.x > 0) {
-                    ballSpeed.x *= -1.1f;
-                    ballSpeed.y = (ballPosition.y - (ai.y + ai.height / 2)) / (ai.height / 2) * std::fabs(ballSpeed.x);
-                }
+        if (IsKeyPressed(KEY_TAB)) {
+            aiLevel = (aiLevel + 1) % PONG_AI_LEVEL_COUNT;
+            game.SetAi(PongCore::RIGHT, &PONG_AI_LEVELS[aiLevel]);
+        }
+        if (IsKeyPressed(KEY_C)) SetChaosSize((chaosIndex + 1) % CHAOS_SIZE_COUNT);
+        if (IsKeyPressed(KEY_B)) {
+            chaos.SetBallCollisions(!chaos.GetBallCollisions());
+            SetChaosSize(chaosIndex); // Report and restart the timings
+        }
 
-                // Scoring Logic
-                bool pointScored = false;
-                if (ballPosition.x - ballRadius > screenWidth) { // Player scores
-                    playerScore++;
-                    ballSpeed.x = -initialBallSpeed;
-                    pointScored = true;
-                }
-                if (ballPosition.x + ballRadius < 0) { // AI scores
-                    aiScore++;
-                    ballSpeed.x = initialBallSpeed;
-                    pointScored = true;
-                }
+        PongAction action = PONG_ACTION_NONE;
+        if (IsKeyDown(KEY_W)) action = PONG_ACTION_UP;
+        else if (IsKeyDown(KEY_S)) action = PONG_ACTION_DOWN;
 
-                if (pointScored) {
-                    ballPosition = { screenWidth / 2.0f, screenHeight / 2.0f };
-                    ballSpeed.y = initialBallSpeed * (GetRandomValue(0, 1) == 0 ? -1 : 1);
-                }
+        if (ChaosActive()) {
+            UpdateChaos(action);
+            return;
+        }
 
-                // Check for a winner
-                if (playerScore >= winningScore) {
-                    winnerText = "Player Wins!";
-                    currentState = GAME_OVER;
-                }
-                if (aiScore >= winningScore) {
-                    winnerText = "AI Wins!";
-                    currentState = GAME_OVER;
-                }
-            } break;
+        if (game.IsGameOver()) {
+            if (IsKeyPressed(KEY_ENTER)) {
+                ResetGame(); // Use the helper function to restart
+            }
+            return;
+        }
 
-            case GAME_OVER: {
-                if (IsKeyPressed(KEY_ENTER)) {
-                    ResetGame(); // Use the helper function to restart
-                }
-            } break;
+        tickAccumulator += GetFrameTime();
+        int ticks = 0;
+        while (tickAccumulator >= TICK_DT && !game.IsGameOver()) {
+            tickAccumulator -= TICK_DT;
+            SavePrevious();
+            PongStepResult result = game.Step(action);
+            if (result.events & PONG_EVENT_POINT) SavePrevious(); // Don't draw the ball sliding back to the centre
+            if (++ticks == MAX_TICKS_PER_FRAME) {
+                tickAccumulator = 0.0f; // Too slow to keep up: drop the rest rather than fall further behind
+                break;
+            }
         }
     }
 
@@ -597,16 +1106,39 @@ public:
         }
 
         // Draw paddles and ball
+        float alpha = tickAccumulator / TICK_DT;
+        Rectangle player = ToRectangle(GetPaddle(PongCore::LEFT)), ai = ToRectangle(GetPaddle(PongCore::RIGHT));
+        player.y = Lerp(prevPlayerY, player.y, alpha);
+        ai.y = Lerp(prevAiY, ai.y, alpha);
         DrawRectangleRec(player, GREEN);
         DrawRectangleRec(ai, GREEN);
-        DrawCircleV(ballPosition, ballRadius, GREEN);
+
+        if (ChaosActive()) {
+            double drawStart = GetTime();
+            DrawChaosBalls(alpha);
+            drawMsTotal += (GetTime() - drawStart) * 1000.0;
+            timedFrames++;
+
+            DrawText(TextFormat("%i", chaos.GetScore(PongCore::LEFT)), screenWidth / 4 - 20, 20, 80, GREEN);
+            DrawText(TextFormat("%i", chaos.GetScore(PongCore::RIGHT)), 3 * screenWidth / 4 - 20, 20, 80, GREEN);
+            DrawText(TextFormat("BALLS: %d [C]  COLLISIONS: %s [B] %d/TICK  STEP: %.2f ms  DRAW: %.2f ms", chaos.GetBallCount(),
+                                chaos.GetBallCollisions() ? "ON" : "OFF", chaos.GetLastContacts(),
+                                stepMsTotal / timedFrames, drawMsTotal / timedFrames), 10, screenHeight - 30, 20, DARKGREEN);
+            return;
+        }
+
+        const PongBall& ball = game.GetBall();
+        DrawCircleV(Vector2Lerp(prevBallPosition, { ball.position.x, ball.position.y }, alpha), ball.radius, GREEN);
 
         // Draw the scores
-        DrawText(TextFormat("%i", playerScore), screenWidth / 4 - 20, 20, 80, GREEN);
-        DrawText(TextFormat("%i", aiScore), 3 * screenWidth / 4 - 20, 20, 80, GREEN);
-        
+        DrawText(TextFormat("%i", game.GetScore(PongCore::LEFT)), screenWidth / 4 - 20, 20, 80, GREEN);
+        DrawText(TextFormat("%i", game.GetScore(PongCore::RIGHT)), 3 * screenWidth / 4 - 20, 20, 80, GREEN);
+        const char* aiText = TextFormat("AI: %s  [TAB]", PONG_AI_LEVELS[aiLevel].name);
+        DrawText(aiText, 3 * screenWidth / 4 - MeasureText(aiText, 20) / 2, screenHeight - 30, 20, DARKGREEN);
+
         // Draw the Game Over screen
-        if (currentState == GAME_OVER) {
+        if (game.IsGameOver()) {
+            const char* winnerText = game.GetWinner() == PongCore::LEFT ? "Player Wins!" : "AI Wins!";
             DrawText(winnerText, GetScreenWidth() / 2 - MeasureText(winnerText, 40) / 2, GetScreenHeight() / 2 - 40, 40, GREEN);
             const char* restartMsg = "Press [ENTER] to Play Again";
             DrawText(restartMsg, GetScreenWidth() / 2 - MeasureText(restartMsg, 20) / 2, GetScreenHeight() / 2 + 20, 20, GREEN);
@@ -0,0 +1,562 @@
+/*******************************************************************************************
+*
+* maze.h - Tile grid and path-finding helpers for the Pac-Man channel
+*
+* Everything in here is plain C++ with no raylib dependency, so the same code is shared by
+* the game (main.cpp) and by the headless benchmarks (bench.cpp).
+*
+********************************************************************************************/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// ---------- Level Text ----------
+// Reads a level file into one string per row. Trailing '\r' from Windows line endings is dropped.
+inline bool LoadLevelLines(const char* fileName, std::vector<std::string>& lines) {
+    lines.clear();
+    std::ifstream file(fileName);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(line);
+    }
+    return true;
+}
+
+// ---------- TileGrid ----------
+// Row-major wall mask. Anything outside the map counts as a wall, same as the old IsWall().
+// exits[] caches which of the four neighbours of each tile are open (EXIT_* bits).
+enum TileExit : uint8_t { EXIT_UP = 1 << 0, EXIT_DOWN = 1 << 1, EXIT_LEFT = 1 << 2, EXIT_RIGHT = 1 << 3 };
+
+// Exit bit for a unit step (dx, dy); 0 for standing still.
+inline uint8_t DirectionExit(int dx, int dy) {
+    if (dy < 0) return EXIT_UP;
+    if (dy > 0) return EXIT_DOWN;
+    if (dx < 0) return EXIT_LEFT;
+    if (dx > 0) return EXIT_RIGHT;
+    return 0;
+}
+
+struct TileGrid {
+    int width = 0, height = 0;
+    std::vector<uint8_t> walls;
+    std::vector<uint8_t> exits;
+
+    void Build(const std::vector<std::string>& lines) {
+        height = (int)lines.size();
+        width = 0;
+        for (const auto& line : lines) width = std::max(width, (int)line.length());
+
+        walls.assign((size_t)width * height, 0);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < (int)lines[y].length(); x++) {
+                if (lines[y][x] == '#') walls[(size_t)y * width + x] = 1;
+            }
+        }
+        BuildExits();
+    }
+
+    void BuildExits() {
+        exits.assign(walls.size(), 0);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint8_t mask = 0;
+                if (!IsWall(x, y - 1)) mask |= EXIT_UP;
+                if (!IsWall(x, y + 1)) mask |= EXIT_DOWN;
+                if (!IsWall(x - 1, y)) mask |= EXIT_LEFT;
+                if (!IsWall(x + 1, y)) mask |= EXIT_RIGHT;
+                exits[Index(x, y)] = mask;
+            }
+        }
+    }
+
+    uint8_t Exits(int x, int y) const {
+        if (!InBounds(x, y)) return 0;
+        return exits[Index(x, y)];
+    }
+
+    bool InBounds(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    int Index(int x, int y) const { return y * width + x; }
+
+    bool IsWall(int x, int y) const {
+        if (!InBounds(x, y)) return true;
+        return walls[Index(x, y)] != 0;
+    }
+};
+
+// ---------- DistanceField ----------
+// Breadth-first distance (in tiles) from a single source tile to every open tile.
+// One field built from a target tile serves every ghost heading there: each one just steps
+// to the neighbour with the smallest value. Build() only does work when the source changes.
+// The game now targets through TileDistanceTable below; `./bench bfs` still times this BFS
+// next to the table on the same maps, for a new target and for the per-ghost step.
+struct DistanceField {
+    static constexpr uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+    std::vector<uint32_t> dist;
+    std::vector<int> queue;
+    int sourceX = -1, sourceY = -1;
+    int rebuildCount = 0;
+
+    void Invalidate() {
+        sourceX = -1;
+        sourceY = -1;
+    }
+
+    uint32_t At(int x, int y, const TileGrid& grid) const {
+        if (dist.empty() || !grid.InBounds(x, y)) return UNREACHABLE;
+        return dist[grid.Index(x, y)];
+    }
+
+    // Returns true if the field was recomputed.
+    bool Build(const TileGrid& grid, int sx, int sy) {
+        if (sx == sourceX && sy == sourceY && dist.size() == grid.walls.size()) return false;
+        if (grid.IsWall(sx, sy)) return false; // e.g. mid-wrap through a tunnel; keep the last field
+
+        sourceX = sx;
+        sourceY = sy;
+        rebuildCount++;
+
+        dist.assign(grid.walls.size(), UNREACHABLE);
+        queue.resize(grid.walls.size());
+
+        int head = 0, tail = 0;
+        int start = grid.Index(sx, sy);
+        dist[start] = 0;
+        queue[tail++] = start;
+
+        const int w = grid.width;
+        const int size = (int)grid.walls.size();
+        const uint8_t* walls = grid.walls.data();
+        uint32_t* d = dist.data();
+        int* q = queue.data();
+
+        auto visit = [&](int index, uint32_t next) {
+            if (walls[index] || d[index] != UNREACHABLE) return;
+            d[index] = next;
+            q[tail++] = index;
+        };
+
+        while (head < tail) {
+            int current = q[head++];
+            int x = current % w;
+            uint32_t next = d[current] + 1;
+
+            if (current >= w) visit(current - w, next);
+            if (current + w < size) visit(current + w, next);
+            if (x > 0) visit(current - 1, next);
+            if (x < w - 1) visit(current + 1, next);
+        }
+        return true;
+    }
+};
+
+// ---------- TileDistanceTable ----------
+// Shortest path length (in tiles) between any two open tiles, so ghost targeting rules
+// (ahead of the player, scatter corners, the way home) are a lookup instead of a search.
+// Rows are indexed by target tile. Small maps get every row at load time; when the full
+// table would exceed the memory budget the rows are filled on first use from a BFS and kept
+// in a fixed-size cache instead. Lazy rows only search LAZY_ROW_RADIUS tiles out from the
+// target, so a miss costs the same on a 1000x1000 maze as on a small one; beyond that radius
+// Distance() falls back to the straight-line tile distance, like the arcade ghosts. Lazy mode
+// mutates the cache, so share a table across threads only when IsLazy() is false.
+struct TileDistanceTable {
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+    static constexpr uint16_t UNEXPLORED = 0xFFFE;  // Lazy rows: outside the searched radius
+    static constexpr int LAZY_ROW_RADIUS = 48;
+
+    int openCount = 0;
+    std::vector<int> tileToOpen;   // grid index -> open tile id, -1 for walls
+    std::vector<int> openToTile;   // open tile id -> grid index
+    std::vector<int> nearestOpen;  // grid index -> grid index of the closest open tile
+    std::vector<int> neighbours;   // 4 open ids per open tile (up, down, left, right), -1 for walls
+
+    std::vector<uint16_t> rows;    // rowCapacity rows of openCount distances
+    std::vector<int> rowOfTarget;  // open id -> row slot, -1 if not cached (lazy only)
+    std::vector<int> targetOfRow;  // row slot -> open id, -1 if free (lazy only)
+    std::vector<uint8_t> rowComplete;           // Row slot search reached every tile (lazy only)
+    std::vector<std::vector<int>> rowTouched;   // Open ids each row slot wrote (lazy only)
+    int rowCapacity = 0;
+    int nextEvict = 0;
+    bool lazy = false;
+
+    double buildMs = 0.0;
+    int rowMisses = 0;
+
+    void Build(const TileGrid& grid, size_t maxTableBytes = 32u << 20) {
+        auto start = std::chrono::steady_clock::now();
+        const int tileCount = grid.width * grid.height;
+
+        tileToOpen.assign(tileCount, -1);
+        openToTile.clear();
+        for (int i = 0; i < tileCount; i++) {
+            if (grid.walls[i]) continue;
+            tileToOpen[i] = (int)openToTile.size();
+            openToTile.push_back(i);
+        }
+        openCount = (int)openToTile.size();
+        BuildNearestOpen(grid);
+
+        neighbours.assign((size_t)openCount * 4, -1);
+        for (int id = 0; id < openCount; id++) {
+            int x = openToTile[id] % grid.width, y = openToTile[id] / grid.width;
+            const int around[4][2] = { {x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y} };
+            for (int n = 0; n < 4; n++) {
+                if (!grid.IsWall(around[n][0], around[n][1])) neighbours[id * 4 + n] = tileToOpen[grid.Index(around[n][0], around[n][1])];
+            }
+        }
+        queue.resize(openCount);
+
+        size_t rowBytes = (size_t)openCount * sizeof(uint16_t);
+        size_t fullBytes = rowBytes * openCount;
+        lazy = fullBytes > maxTableBytes;
+        rowCapacity = lazy ? (int)std::max<size_t>(1, maxTableBytes / std::max<size_t>(rowBytes, 1)) : openCount;
+        rowCapacity = std::min(rowCapacity, std::max(openCount, 1));
+
+        rows.assign((size_t)rowCapacity * openCount, lazy ? UNEXPLORED : UNREACHABLE);
+        rowOfTarget.assign(openCount, -1);
+        targetOfRow.assign(rowCapacity, -1);
+        rowComplete.assign(lazy ? rowCapacity : 0, 0);
+        rowTouched.assign(lazy ? rowCapacity : 0, {});
+        nextEvict = 0;
+        rowMisses = 0;
+
+        if (!lazy) {
+            for (int id = 0; id < openCount; id++) FillRow(id);
+        }
+        buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool IsLazy() const { return lazy; }
+
+    size_t MemoryBytes() const {
+        return rows.size() * sizeof(uint16_t)
+             + (tileToOpen.size() + openToTile.size() + nearestOpen.size() + neighbours.size()
+                + queue.size() + rowOfTarget.size() + targetOfRow.size()) * sizeof(int);
+    }
+
+    // Closest open tile to (x, y), clamping off-map coordinates first. Targets like
+    // "four tiles ahead of the player" often land in a wall or outside the maze.
+    int NearestOpenTile(const TileGrid& grid, int x, int y) const {
+        if (nearestOpen.empty()) return -1;
+        x = std::clamp(x, 0, grid.width - 1);
+        y = std::clamp(y, 0, grid.height - 1);
+        return nearestOpen[grid.Index(x, y)];
+    }
+
+    // Path length from (fromX, fromY) to the open tile nearest (toX, toY). Lazy tables
+    // estimate paths longer than LAZY_ROW_RADIUS as the radius plus the Manhattan distance.
+    uint16_t Distance(const TileGrid& grid, int fromX, int fromY, int toX, int toY) {
+        if (!grid.InBounds(fromX, fromY)) return UNREACHABLE;
+        int from = tileToOpen[grid.Index(fromX, fromY)];
+        int to = NearestOpenTile(grid, toX, toY);
+        if (from < 0 || to < 0) return UNREACHABLE;
+        if (!lazy) return rows[(size_t)tileToOpen[to] * openCount + from];
+
+        int slot = LazyRow(tileToOpen[to]);
+        uint16_t distance = rows[(size_t)slot * openCount + from];
+        if (distance != UNEXPLORED) return distance;
+        if (rowComplete[slot]) return UNREACHABLE;
+        int manhattan = std::abs(fromX - to % grid.width) + std::abs(fromY - to / grid.width);
+        return (uint16_t)std::min(LAZY_ROW_RADIUS + manhattan, UNEXPLORED - 1);
+    }
+
+    // Read-only lookup by open tile id, safe to call from many threads. Full tables only.
+    uint16_t FullTableDistance(int fromOpenId, int toOpenId) const {
+        return rows[(size_t)toOpenId * openCount + fromOpenId];
+    }
+
+private:
+    std::vector<int> queue;
+
+    int LazyRow(int target) {
+        int slot = rowOfTarget[target];
+        if (slot < 0) {
+            slot = nextEvict;
+            nextEvict = (nextEvict + 1) % rowCapacity;
+            if (targetOfRow[slot] >= 0) rowOfTarget[targetOfRow[slot]] = -1;
+            FillLazyRow(target, slot);
+            rowMisses++;
+        }
+        return slot;
+    }
+
+    // Full tables: BFS over open tiles only, writing straight into the row. Paths longer
+    // than 65534 tiles saturate rather than wrap.
+    void FillRow(int target) {
+        uint16_t* row = &rows[(size_t)target * openCount];
+        std::fill(row, row + openCount, UNREACHABLE);
+
+        int head = 0, tail = 0;
+        row[target] = 0;
+        queue[tail++] = target;
+        while (head < tail) {
+            int current = queue[head++];
+            uint16_t next = (uint16_t)std::min<int>(row[current] + 1, UNREACHABLE - 1);
+            const int* around = &neighbours[(size_t)current * 4];
+            for (int n = 0; n < 4; n++) {
+                int id = around[n];
+                if (id < 0 || row[id] != UNREACHABLE) continue;
+                row[id] = next;
+                queue[tail++] = id;
+            }
+        }
+    }
+
+    // Radius-limited BFS. Only the entries the previous search wrote are cleared, so the
+    // cost tracks the radius rather than the size of the maze.
+    void FillLazyRow(int target, int slot) {
+        uint16_t* row = &rows[(size_t)slot * openCount];
+        std::vector<int>& touched = rowTouched[slot];
+        for (int id : touched) row[id] = UNEXPLORED;
+
+        int head = 0, tail = 0;
+        bool cutOff = false;
+        row[target] = 0;
+        queue[tail++] = target;
+        while (head < tail) {
+            int current = queue[head++];
+            const int* around = &neighbours[(size_t)current * 4];
+            for (int n = 0; n < 4; n++) {
+                int id = around[n];
+                if (id < 0 || row[id] != UNEXPLORED) continue;
+                if (row[current] >= LAZY_ROW_RADIUS) {
+                    cutOff = true;
+                    continue;
+                }
+                row[id] = (uint16_t)(row[current] + 1);
+                queue[tail++] = id;
+            }
+        }
+
+        touched.assign(queue.begin(), queue.begin() + tail);
+        rowComplete[slot] = cutOff ? 0 : 1;
+        rowOfTarget[target] = slot;
+        targetOfRow[slot] = target;
+    }
+
+    // Multi-source BFS from every open tile across the whole grid, walls included.
+    void BuildNearestOpen(const TileGrid& grid) {
+        const int w = grid.width;
+        const int size = w * grid.height;
+        nearestOpen.assign(size, -1);
+
+        std::vector<int> queue(size);
+        int head = 0, tail = 0;
+        for (int i : openToTile) {
+            nearestOpen[i] = i;
+            queue[tail++] = i;
+        }
+        while (head < tail) {
+            int current = queue[head++];
+            int x = current % w;
+            int neighbours[4] = { current - w, current + w, x > 0 ? current - 1 : -1, x < w - 1 ? current + 1 : -1 };
+            for (int n : neighbours) {
+                if (n < 0 || n >= size || nearestOpen[n] >= 0) continue;
+                nearestOpen[n] = nearestOpen[current];
+                queue[tail++] = n;
+            }
+        }
+    }
+};
+
+// ---------- MazeAnalysis ----------
+// Facts about a maze worked out once at load time, so movement code doesn't rediscover them
+// with wall probes every tick:
+//   exits      TileGrid exits plus the wrap-around exits of tunnels: open tiles facing each
+//              other across opposite edges of the map
+//   nodes      tiles where an entity can do anything but carry straight on (junctions,
+//              corners, dead ends, tunnel mouths). Every other open tile is a corridor tile
+//              with exactly two opposite exits, where the only choice is to keep going
+//   segments   the corridors between nodes and their length in tiles
+//   reachable  open tiles the player can walk to from its start. A pellet anywhere else can
+//              never be eaten and would make the level unwinnable
+// Directions are 0 up, 1 down, 2 left, 3 right, matching the EXIT_* bits; d ^ 1 is the
+// opposite of d.
+struct MazeAnalysis {
+    struct Segment { int from, to, length; uint8_t direction; }; // Grid indices; leaves 'from' heading 'direction'
+    struct Tunnel { int a, b; };                                 // Grid indices of the two mouths
+
+    int width = 0, height = 0;
+    std::vector<uint8_t> exits;
+    std::vector<uint8_t> isNode;
+    std::vector<uint8_t> reachable;
+    std::vector<Segment> segments;
+    std::vector<Tunnel> tunnels;
+    int nodeCount = 0, junctionCount = 0, reachableCount = 0, longestSegment = 0;
+    double buildMs = 0.0;
+
+    // Reachability is measured from (startX, startY); pass a wall or an off-map tile to treat
+    // every open tile as reachable.
+    void Build(const TileGrid& grid, int startX, int startY) {
+        auto start = std::chrono::steady_clock::now();
+        width = grid.width;
+        height = grid.height;
+        exits = grid.exits;
+        const int tileCount = width * height;
+
+        tunnels.clear();
+        for (int y = 0; y < height && width > 1; y++) {
+            if (grid.IsWall(0, y) || grid.IsWall(width - 1, y)) continue;
+            exits[grid.Index(0, y)] |= EXIT_LEFT;
+            exits[grid.Index(width - 1, y)] |= EXIT_RIGHT;
+            tunnels.push_back({ grid.Index(0, y), grid.Index(width - 1, y) });
+        }
+        for (int x = 0; x < width && height > 1; x++) {
+            if (grid.IsWall(x, 0) || grid.IsWall(x, height - 1)) continue;
+            exits[grid.Index(x, 0)] |= EXIT_UP;
+            exits[grid.Index(x, height - 1)] |= EXIT_DOWN;
+            tunnels.push_back({ grid.Index(x, 0), grid.Index(x, height - 1) });
+        }
+
+        isNode.assign(tileCount, 0);
+        nodeCount = junctionCount = 0;
+        for (int i = 0; i < tileCount; i++) {
+            if (grid.walls[i]) continue;
+            uint8_t e = exits[i];
+            bool straight = e == (EXIT_UP | EXIT_DOWN) || e == (EXIT_LEFT | EXIT_RIGHT);
+            bool mouth = exits[i] != grid.exits[i];
+            if (straight && !mouth) continue;
+            isNode[i] = 1;
+            nodeCount++;
+            if (((e & 1) + (e >> 1 & 1) + (e >> 2 & 1) + (e >> 3 & 1)) >= 3) junctionCount++;
+        }
+
+        // Walk every corridor from both ends, keeping it once
+        segments.clear();
+        longestSegment = 0;
+        for (int node = 0; node < tileCount; node++) {
+            if (!isNode[node]) continue;
+            for (int d = 0; d < 4; d++) {
+                int tile = Step(node, d), length = 1;
+                if (tile < 0) continue;
+                while (!isNode[tile] && length < tileCount) {
+                    tile = Step(tile, d);
+                    length++;
+                }
+                if (tile < node || (tile == node && (d & 1))) continue;
+                segments.push_back({ node, tile, length, (uint8_t)d });
+                longestSegment = std::max(longestSegment, length);
+            }
+        }
+
+        reachable.assign(tileCount, 0);
+        reachableCount = 0;
+        if (grid.IsWall(startX, startY)) {
+            for (int i = 0; i < tileCount; i++) reachable[i] = grid.walls[i] ? 0 : 1;
+            reachableCount = (int)std::count(reachable.begin(), reachable.end(), 1);
+        } else {
+            std::vector<int> queue;
+            queue.reserve(tileCount);
+            queue.push_back(grid.Index(startX, startY));
+            reachable[queue[0]] = 1;
+            for (size_t head = 0; head < queue.size(); head++) {
+                for (int d = 0; d < 4; d++) {
+                    int next = Step(queue[head], d);
+                    if (next < 0 || reachable[next]) continue;
+                    reachable[next] = 1;
+                    queue.push_back(next);
+                }
+            }
+            reachableCount = (int)queue.size();
+        }
+        buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    uint8_t Exits(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return 0;
+        return exits[y * width + x];
+    }
+
+    bool IsNode(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height && isNode[y * width + x]; }
+    bool IsReachable(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height && reachable[y * width + x]; }
+
+    // Neighbour of grid index 'index' in direction d, through tunnels; -1 if that way is shut.
+    int Step(int index, int d) const {
+        if (!(exits[index] & (1 << d))) return -1;
+        int x = index % width, y = index / width;
+        switch (d) {
+            case 0: y = y > 0 ? y - 1 : height - 1; break;
+            case 1: y = y < height - 1 ? y + 1 : 0; break;
+            case 2: x = x > 0 ? x - 1 : width - 1; break;
+            default: x = x < width - 1 ? x + 1 : 0; break;
+        }
+        return y * width + x;
+    }
+};
+
+// ---------- Maze Generator ----------
+// Builds a level in the same text format as level.txt: a braided depth-first maze with a
+// pellet on every corridor tile, power pellets in the corners, the player in the middle
+// and a row of ghosts above them. Used for stress-testing large maps.
+inline std::vector<std::string> GenerateMazeLines(int width, int height, unsigned seed, int ghostCount = 4) {
+    // Cells live on odd coordinates, so force odd dimensions.
+    if (width % 2 == 0) width++;
+    if (height % 2 == 0) height++;
+    width = std::max(width, 7);
+    height = std::max(height, 7);
+
+    std::vector<std::string> lines(height, std::string(width, '#'));
+    std::mt19937 rng(seed);
+
+    const int dirs[4][2] = { {0, -2}, {0, 2}, {-2, 0}, {2, 0} };
+    std::vector<std::pair<int, int>> stack;
+    stack.push_back({1, 1});
+    lines[1][1] = '.';
+
+    while (!stack.empty()) {
+        auto [cx, cy] = stack.back();
+        int order[4] = {0, 1, 2, 3};
+        std::shuffle(order, order + 4, rng);
+
+        bool carved = false;
+        for (int i : order) {
+            int nx = cx + dirs[i][0], ny = cy + dirs[i][1];
+            if (nx <= 0 || nx >= width - 1 || ny <= 0 || ny >= height - 1) continue;
+            if (lines[ny][nx] != '#') continue;
+            lines[cy + dirs[i][1] / 2][cx + dirs[i][0] / 2] = '.';
+            lines[ny][nx] = '.';
+            stack.push_back({nx, ny});
+            carved = true;
+            break;
+        }
+        if (!carved) stack.pop_back();
+    }
+
+    // Knock out some extra walls so there are loops to run around, like a real Pac-Man maze.
+    std::uniform_int_distribution<int> coin(0, 3);
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            if (lines[y][x] != '#') continue;
+            bool horizontal = lines[y][x - 1] == '.' && lines[y][x + 1] == '.' && lines[y - 1][x] == '#' && lines[y + 1][x] == '#';
+            bool vertical = lines[y - 1][x] == '.' && lines[y + 1][x] == '.' && lines[y][x - 1] == '#' && lines[y][x + 1] == '#';
+            if ((horizontal || vertical) && coin(rng) == 0) lines[y][x] = '.';
+        }
+    }
+
+    lines[1][1] = 'O';
+    lines[1][width - 2] = 'O';
+    lines[height - 2][1] = 'O';
+    lines[height - 2][width - 2] = 'O';
+
+    int midX = width / 2 | 1, midY = height / 2 | 1;
+    lines[midY][midX] = 'P';
+    for (int i = 0, placed = 0; placed < ghostCount && i < width * height; i++) {
+        int x = 1 + (i % (width - 2));
+        int y = std::max(1, midY - 2 - 2 * (i / (width - 2)));
+        if (lines[y][x] == '.') {
+            lines[y][x] = 'G';
+            placed++;
+        }
+    }
+    return lines;
+}
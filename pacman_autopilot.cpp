@@ -0,0 +1,343 @@
+/*******************************************************************************************
+*
+* pacman_autopilot.cpp - Monte-Carlo tree search bot for PacmanCore (see pacman_autopilot.h)
+*
+********************************************************************************************/
+#include "pacman_autopilot.h"
+#include <cmath>
+
+static constexpr float EXPLORATION = 0.5f;      // UCB1 constant; values are in [0, 1]
+static constexpr float FULL_SCORE_RATE = 1.2f;  // Points per tick worth a full score: a pellet per tile
+
+// Table entry layout: valid flag, rollout count (7 bits), surviving rollouts (7 bits), mean
+// points x4 (25 bits), mean nearest-pellet distance x16 (24 bits).
+static constexpr uint64_t STATS_VALID = 1ull << 63;
+static constexpr int STATS_MAX_COUNT = 127;
+
+template <typename Stats>
+static uint64_t PackStats(const Stats& stats) {
+    uint64_t points = (uint64_t)std::min(std::max(stats.points, 0.0f) * 4.0f + 0.5f, (float)((1 << 25) - 1));
+    uint64_t nearest = (uint64_t)std::min(stats.nearest * 16.0f + 0.5f, (float)((1 << 24) - 1));
+    return STATS_VALID | (uint64_t)stats.count << 56 | (uint64_t)stats.alive << 49 | points << 24 | nearest;
+}
+
+template <typename Stats>
+static void UnpackStats(uint64_t data, Stats& stats) {
+    stats.count = (int)(data >> 56) & 0x7F;
+    stats.alive = (int)(data >> 49) & 0x7F;
+    stats.points = ((data >> 24) & 0x1FFFFFF) / 4.0f;
+    stats.nearest = (data & 0xFFFFFF) / 16.0f;
+}
+
+// Expected value of a leaf 'ticksBeforeRollout' ticks and 'pointsBeforeRollout' points past
+// the root. Points are scored as a rate, so dawdling (e.g. never leaving the READY state,
+// where ghosts can't move) is worse than scoring the same points sooner.
+template <typename Stats>
+static float StatsValue(const Stats& stats, int pointsBeforeRollout, int ticksBeforeRollout) {
+    if (stats.alive == 0) return 0.0f;
+    float survival = (float)stats.alive / stats.count;
+    int ticks = ticksBeforeRollout + PacmanAutopilot::ROLLOUT_DECISIONS * PacmanAutopilot::DECISION_TICKS;
+    float rate = std::min(1.0f, (pointsBeforeRollout + stats.points) / ticks / FULL_SCORE_RATE);
+    return survival * (0.2f + 0.6f * rate + 0.2f / (1.0f + stats.nearest));
+}
+
+//----------------------------------------------------------------------------------
+// Setup
+//----------------------------------------------------------------------------------
+
+bool PacmanAutopilot::Start(const PacmanCore& level, int threadCount) {
+    Stop();
+    if (!level.IsLoaded() || !level.CanSnapshot() || level.GetDistanceTable().IsLazy()) return false;
+
+#ifdef PACMAN_AUTOPILOT_INLINE
+    threadCount = 1;
+#else
+    if (threadCount <= 0) threadCount = (int)std::max(2u, std::thread::hardware_concurrency()) - 1;
+#endif
+
+    const TileGrid& grid = level.GetGrid();
+    const TileDistanceTable& distances = level.GetDistanceTable();
+    pelletOpenIds.clear();
+    for (FixVec2 position : level.GetPellets().position) {
+        Vec2 tile = PacmanCore::WorldToTile(position);
+        pelletOpenIds.push_back(distances.tileToOpen[grid.Index((int)tile.x, (int)tile.y)]);
+    }
+    predictor = level;
+    table.Resize(tableEntries);
+
+    stopping = false;
+    hasRoot = false;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(new Worker());
+        Worker& worker = *workers.back();
+        worker.game = level;
+        worker.tree.reserve(MAX_TREE_NODES);
+        worker.rng.seed(1234 + i);
+    }
+#ifndef PACMAN_AUTOPILOT_INLINE
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { WorkerLoop(*w); });
+    }
+#endif
+
+    lastSampleTime = Clock::now();
+    lastSampleRollouts = rollouts.load();
+    rolloutsPerSecond = 0.0;
+    return true;
+}
+
+void PacmanAutopilot::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    workers.clear();
+}
+
+void PacmanAutopilot::Restart() {
+    currentAction = ACTION_NONE;
+    ticksUntilDecision = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    hasRoot = false;
+    publishedGeneration.store(++rootGeneration);
+}
+
+//----------------------------------------------------------------------------------
+// Render thread
+//----------------------------------------------------------------------------------
+
+PacAction PacmanAutopilot::NextAction(const PacmanCore& game) {
+    if (workers.empty()) return ACTION_NONE;
+
+    // The search root published at the last decision is exactly this tick's state
+    if (ticksUntilDecision == 0) {
+        if (hasRoot) {
+            PacAction best = BestRootAction();
+            if (best != ACTION_NONE) currentAction = best;
+        }
+        PublishRoot(game, currentAction);
+        ticksUntilDecision = DECISION_TICKS;
+    }
+    ticksUntilDecision--;
+    return currentAction;
+}
+
+// Most visited root move across every worker's tree. Workers that haven't picked up the
+// current root yet have nothing to say about it.
+PacAction PacmanAutopilot::BestRootAction() const {
+    unsigned generation = publishedGeneration.load();
+    int visits[4] = {};
+    for (const auto& worker : workers) {
+        if (worker->countsGeneration.load(std::memory_order_acquire) != generation) continue;
+        for (int a = 0; a < 4; a++) visits[a] += worker->rootVisits[a].load(std::memory_order_relaxed);
+    }
+
+    int best = -1;
+    for (int a = 0; a < 4; a++) {
+        if (visits[a] > 0 && (best < 0 || visits[a] > visits[best])) best = a;
+    }
+    return best < 0 ? ACTION_NONE : (PacAction)(ACTION_UP + best);
+}
+
+// Plays 'action' forward on a private copy to get the state at the next decision point.
+void PacmanAutopilot::PublishRoot(const PacmanCore& game, PacAction action) {
+    PacmanCore::Snapshot state;
+    if (!game.SaveSnapshot(state) || !predictor.RestoreSnapshot(state)) return;
+    for (int t = 0; t < DECISION_TICKS; t++) predictor.Step(action);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    predictor.SaveSnapshot(root);
+    hasRoot = true;
+    publishedGeneration.store(++rootGeneration);
+}
+
+void PacmanAutopilot::Think(float budgetSeconds) {
+    Clock::time_point now = Clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastSampleTime).count();
+    if (elapsed >= 0.5) {
+        long long count = rollouts.load(std::memory_order_relaxed);
+        rolloutsPerSecond = (count - lastSampleRollouts) / elapsed;
+        lastSampleRollouts = count;
+        lastSampleTime = now;
+    }
+    if (workers.empty()) return;
+
+    Clock::time_point until = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(budgetSeconds));
+#ifdef PACMAN_AUTOPILOT_INLINE
+    if (!hasRoot) return;
+    Worker& worker = *workers[0];
+    if (worker.rootGeneration != rootGeneration) PickUpRoot(worker);
+    while (Clock::now() < until) Iterate(worker);
+#else
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        deadline = until;
+    }
+    wake.notify_all();
+#endif
+}
+
+double PacmanAutopilot::GetTranspositionHitRate() const {
+    long long probes = 0, hits = 0;
+    for (const auto& worker : workers) {
+        probes += worker->tableProbes.load(std::memory_order_relaxed);
+        hits += worker->tableHits.load(std::memory_order_relaxed);
+    }
+    return probes > 0 ? (double)hits / probes : 0.0;
+}
+
+//----------------------------------------------------------------------------------
+// Search
+//----------------------------------------------------------------------------------
+
+void PacmanAutopilot::WorkerLoop(Worker& worker) {
+    while (true) {
+        Clock::time_point until;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || (hasRoot && Clock::now() < deadline); });
+            if (stopping) return;
+            until = deadline;
+            if (worker.rootGeneration != rootGeneration) PickUpRoot(worker);
+        }
+        while (Clock::now() < until && publishedGeneration.load(std::memory_order_relaxed) == worker.rootGeneration) {
+            Iterate(worker);
+        }
+    }
+}
+
+// Called with 'mutex' held (or inline, where there is no other thread).
+void PacmanAutopilot::PickUpRoot(Worker& worker) {
+    worker.root = root;
+    worker.rootGeneration = rootGeneration;
+    worker.tree.clear();
+    worker.tree.emplace_back();
+    for (auto& visits : worker.rootVisits) visits.store(0, std::memory_order_relaxed);
+    worker.countsGeneration.store(rootGeneration, std::memory_order_release);
+}
+
+// Holds 'action' for one decision. Returns false if the player died on the way.
+bool PacmanAutopilot::Simulate(Worker& worker, PacAction action, int& ticks) {
+    for (int t = 0; t < DECISION_TICKS; t++) {
+        PacStepResult result = worker.game.Step(action);
+        ticks++;
+        if (result.events & EVENT_PLAYER_DIED) return false;
+        if (result.done) break;
+    }
+    return true;
+}
+
+// Being near food breaks ties between quiet futures, so the bot doesn't idle in cleared
+// corridors.
+int PacmanAutopilot::NearestPelletDistance(const PacmanCore& game) const {
+    const TileGrid& grid = game.GetGrid();
+    const TileDistanceTable& distances = game.GetDistanceTable();
+    Vec2 tile = PacmanCore::WorldToTile(game.GetPlayer().position);
+    int from = grid.InBounds((int)tile.x, (int)tile.y) ? distances.tileToOpen[grid.Index((int)tile.x, (int)tile.y)] : -1;
+    int nearest = TileDistanceTable::UNREACHABLE;
+    if (from < 0) return nearest;
+    for (int i = 0; i < (int)pelletOpenIds.size(); i++) {
+        if (game.IsPelletActive(i) && pelletOpenIds[i] >= 0) nearest = std::min<int>(nearest, distances.FullTableDistance(from, pelletOpenIds[i]));
+    }
+    return nearest;
+}
+
+// Random play from the current state, folded into 'stats'. Counts saturate, after which the
+// means become moving averages.
+void PacmanAutopilot::Rollout(Worker& worker, int& ticks, RolloutStats& stats) {
+    PacmanCore& game = worker.game;
+    int scoreBefore = game.GetScore();
+    bool alive = true;
+
+    PacAction action = (PacAction)(ACTION_UP + worker.rng() % 4);
+    for (int d = 0; alive && d < ROLLOUT_DECISIONS && !game.IsFinished(); d++) {
+        if (worker.rng() & 1) action = (PacAction)(ACTION_UP + worker.rng() % 4);
+        alive = Simulate(worker, action, ticks);
+    }
+
+    if (stats.count < STATS_MAX_COUNT) stats.count++;
+    else if (stats.alive > 0 && !alive) stats.alive--;
+    if (!alive) return;
+    if (stats.alive < stats.count) stats.alive++;
+
+    // A cleared level is as good as a full score with food underfoot
+    float points = game.IsVictory() ? FULL_SCORE_RATE * ROLLOUT_DECISIONS * DECISION_TICKS : (float)(game.GetScore() - scoreBefore);
+    float nearest = game.IsVictory() ? 0.0f : (float)NearestPelletDistance(game);
+    stats.points += (points - stats.points) / stats.alive;
+    stats.nearest += (nearest - stats.nearest) / stats.alive;
+}
+
+// One MCTS iteration: select by UCB1 from the root, expand one level, roll out randomly,
+// back the value up the path.
+void PacmanAutopilot::Iterate(Worker& worker) {
+    PacmanCore& game = worker.game;
+    std::vector<Node>& tree = worker.tree;
+    game.RestoreSnapshot(worker.root);
+    int scoreBefore = game.GetScore();
+    int ticks = 0;
+    bool alive = true;
+
+    worker.path.clear();
+    worker.path.push_back(0);
+    int node = 0;
+    for (int depth = 0; alive && !game.IsFinished(); depth++) {
+        if (tree[node].firstChild < 0) {
+            if (tree[node].visits == 0 || depth >= MAX_TREE_DEPTH || (int)tree.size() + 4 > MAX_TREE_NODES) break;
+            tree[node].firstChild = (int)tree.size();
+            tree.resize(tree.size() + 4);
+        }
+
+        int first = tree[node].firstChild;
+        float logVisits = std::log((float)std::max(1, tree[node].visits));
+        int best = 0;
+        float bestScore = -1.0f;
+        for (int c = 0; c < 4; c++) {
+            const Node& child = tree[first + c];
+            float score = child.visits == 0
+                ? 1e6f + (float)(worker.rng() & 0xFF)  // Unvisited first, in random order
+                : child.totalValue / child.visits + EXPLORATION * std::sqrt(logVisits / child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+
+        node = first + best;
+        worker.path.push_back(node);
+        alive = Simulate(worker, (PacAction)(ACTION_UP + best), ticks);
+    }
+
+    // Leaf: reuse the rollouts of an equivalent state if any thread has cached enough of them
+    float value = 0.0f;
+    if (alive) {
+        uint64_t key = game.GetZobristHash(), data;
+        int pointsBeforeRollout = game.GetScore() - scoreBefore, ticksBeforeRollout = ticks;
+        RolloutStats stats;
+        bool useTable = table.GetEntryCount() > 0 && !game.IsFinished();
+        if (useTable) {
+            worker.tableProbes.fetch_add(1, std::memory_order_relaxed);
+            if (table.Probe(key, data)) UnpackStats(data, stats);
+        }
+        if (stats.count >= TABLE_TRUST_ROLLOUTS) {
+            worker.tableHits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            Rollout(worker, ticks, stats);
+            if (useTable) table.Store(key, PackStats(stats));
+        }
+        value = StatsValue(stats, pointsBeforeRollout, ticksBeforeRollout);
+    }
+    for (int n : worker.path) {
+        tree[n].visits++;
+        tree[n].totalValue += value;
+    }
+    if (worker.path.size() > 1) worker.rootVisits[worker.path[1] - tree[0].firstChild].fetch_add(1, std::memory_order_relaxed);
+
+    rollouts.fetch_add(1, std::memory_order_relaxed);
+    simulatedTicks.fetch_add(ticks, std::memory_order_relaxed);
+}
@@ -0,0 +1,151 @@
+/*******************************************************************************************
+*
+* pacman_autopilot.h - Monte-Carlo tree search bot for PacmanCore
+*
+* Plays Pac-Man by searching over future game states. The player changes direction at most
+* once every DECISION_TICKS ticks, so a tree node is "hold this direction for the next
+* DECISION_TICKS ticks"; each search iteration restores the root Snapshot, walks the tree by
+* UCB1, finishes with a short random rollout and scores the result (points gained, lives
+* kept, distance to the nearest pellet). Rollout statistics are cached in a transposition
+* table shared by every thread, keyed by the Zobrist hash of the state the rollouts started
+* from. Once a configuration has TABLE_TRUST_ROLLOUTS samples, reaching it again (by another
+* path, on another thread or in the next decision's search) reuses them instead of rolling
+* out.
+*
+* The search runs on background threads, each with its own copy of the level and its own
+* tree (root parallelism), so the render thread never waits on it. Because the core is
+* deterministic, the state at the next decision point is known exactly one decision early;
+* the workers search that state while the current decision plays out:
+*
+*     autopilot.Start(game);                    // once per level
+*     autopilot.Restart();                      // after Reset(), rewind, ...
+*     game.Step(autopilot.NextAction(game));    // every tick
+*     autopilot.Think(0.008f);                  // every frame: let the workers search 8 ms
+*
+* Web builds without pthreads search inline inside Think(), within the same budget.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pacman_core.h"
+#include "transposition_table.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <memory>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define PACMAN_AUTOPILOT_INLINE
+#endif
+
+class PacmanAutopilot {
+public:
+    static constexpr int DECISION_TICKS = 8;      // About one tile at player speed
+    static constexpr int MAX_TREE_DEPTH = 12;     // Decisions below the root
+    static constexpr int ROLLOUT_DECISIONS = 6;   // Random decisions after leaving the tree
+    static constexpr int MAX_TREE_NODES = 1 << 16;
+    static constexpr size_t DEFAULT_TABLE_ENTRIES = 1 << 18; // 4 MB
+    static constexpr int TABLE_TRUST_ROLLOUTS = 4;
+
+    PacmanAutopilot() = default;
+    ~PacmanAutopilot() { Stop(); }
+    PacmanAutopilot(const PacmanAutopilot&) = delete;
+    PacmanAutopilot& operator=(const PacmanAutopilot&) = delete;
+
+    // Copies the level into every search thread. threadCount 0 leaves one hardware thread
+    // for rendering and uses the rest. Fails on levels that can't be snapshotted or that use
+    // a lazy distance table (huge mazes, ghost swarms).
+    bool Start(const PacmanCore& level, int threadCount = 0);
+    void Stop();
+    bool IsRunning() const { return !workers.empty(); }
+
+    // Rollout cache size for the next Start(); 0 turns the cache off.
+    void SetTranspositionTableSize(size_t entries) { tableEntries = entries; }
+
+    // Forgets the plan; the next NextAction() starts over from whatever state it is given.
+    void Restart();
+
+    // Action to step this tick. Call exactly once before every Step() of 'game'.
+    PacAction NextAction(const PacmanCore& game);
+
+    // Lets the search run for 'budgetSeconds' from now. Returns at once unless the build
+    // searches inline.
+    void Think(float budgetSeconds);
+
+    int GetThreadCount() const { return (int)workers.size(); }
+    double GetRolloutsPerSecond() const { return rolloutsPerSecond; }
+    long long GetRolloutCount() const { return rollouts.load(std::memory_order_relaxed); }
+    long long GetSimulatedTicks() const { return simulatedTicks.load(std::memory_order_relaxed); }
+    double GetTranspositionHitRate() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Running means over the rollouts from one state; packed into a table entry.
+    struct RolloutStats {
+        int count = 0, alive = 0;
+        float points = 0.0f;   // Mean over surviving rollouts
+        float nearest = 0.0f;  // Mean distance to the nearest pellet at the end, same
+    };
+
+    struct Node {
+        int firstChild = -1;  // Children are 4 consecutive nodes, one per direction
+        int visits = 0;
+        float totalValue = 0.0f;
+    };
+
+    struct alignas(64) Worker {
+        std::thread thread;
+        PacmanCore game;
+        std::vector<Node> tree;
+        std::vector<int> path;
+        std::mt19937 rng;
+        PacmanCore::Snapshot root;
+        unsigned rootGeneration = 0;
+
+        // Root child visit counts for rootGeneration, read by the render thread
+        std::atomic<unsigned> countsGeneration{0};
+        std::atomic<int> rootVisits[4];
+
+        // Rollout cache lookups by this worker
+        std::atomic<long long> tableProbes{0}, tableHits{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<int> pelletOpenIds;  // Open tile id of every pellet, for the leaf heuristic
+    TranspositionTable table;        // Leaf Zobrist hash -> packed rollout outcome
+    size_t tableEntries = DEFAULT_TABLE_ENTRIES;
+
+    // Shared with the workers, guarded by 'mutex'
+    std::mutex mutex;
+    std::condition_variable wake;
+    PacmanCore::Snapshot root;
+    unsigned rootGeneration = 0;
+    bool hasRoot = false;
+    bool stopping = false;
+    Clock::time_point deadline;
+
+    std::atomic<unsigned> publishedGeneration{0};
+    std::atomic<long long> rollouts{0}, simulatedTicks{0};
+
+    // Render thread only
+    PacmanCore predictor;
+    PacAction currentAction = ACTION_NONE;
+    int ticksUntilDecision = 0;
+    long long lastSampleRollouts = 0;
+    Clock::time_point lastSampleTime;
+    double rolloutsPerSecond = 0.0;
+
+    PacAction BestRootAction() const;
+    void PublishRoot(const PacmanCore& game, PacAction action);
+    void WorkerLoop(Worker& worker);
+    void PickUpRoot(Worker& worker);
+    void Iterate(Worker& worker);
+    bool Simulate(Worker& worker, PacAction action, int& ticks);
+    void Rollout(Worker& worker, int& ticks, RolloutStats& stats);
+    int NearestPelletDistance(const PacmanCore& game) const;
+};
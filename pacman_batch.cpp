@@ -0,0 +1,278 @@
+/*******************************************************************************************
+*
+* pacman_batch.cpp - Many independent Pac-Man games stepped together (see pacman_batch.h)
+*
+* Player movement, ghost targeting and ghost turns are PacmanCore's own rule functions, run
+* on this file's arrays; the loops around them follow PacmanCore::Step() step for step, so
+* a game in the batch plays out exactly like a PacmanCore fed the same actions. `./bench
+* parity` checks that, field by field and tick by tick.
+*
+********************************************************************************************/
+#include "pacman_batch.h"
+
+//----------------------------------------------------------------------------------
+// Setup
+//----------------------------------------------------------------------------------
+
+bool PacmanBatch::Init(const PacmanCore& level, int count, int threadCount) {
+    if (!level.IsLoaded() || count <= 0) return false;
+    if (level.GetDistanceTable().IsLazy()) return false; // Lazy rows can't be shared across threads
+
+    grid = level.GetGrid();
+    table = level.GetDistanceTable();
+    maze = level.GetMazeAnalysis();
+    gameCount = count;
+
+    const auto& pellets = level.GetPellets();
+    pelletCount = pellets.Count();
+    pelletWords = std::max(1, (pelletCount + 63) / 64);
+    pelletAtTile.assign(grid.walls.size(), -1);
+    pelletX.clear(); pelletY.clear(); pelletRadius.clear(); pelletPoints.clear(); pelletIsPower.clear();
+    startPelletBits.assign(pelletWords, 0);
+    startPelletCount = 0;
+    for (int i = 0; i < pelletCount; i++) {
+        Vec2 tile = PacmanCore::WorldToTile(pellets.position[i]);
+        pelletAtTile[grid.Index((int)tile.x, (int)tile.y)] = i;
+        pelletX.push_back(pellets.position[i].x);
+        pelletY.push_back(pellets.position[i].y);
+        pelletRadius.push_back(pellets.radius[i]);
+        pelletPoints.push_back(pellets.Points(i));
+        pelletIsPower.push_back(pellets.isPowerPellet[i]);
+        if (level.IsPelletReachable(i)) {
+            startPelletBits[i / 64] |= 1ull << (i % 64);
+            startPelletCount++;
+        }
+    }
+
+    const auto& ghosts = level.GetGhosts();
+    ghostsPerGame = ghosts.Count();
+    ghostStartX.clear(); ghostStartY.clear(); ghostType.clear();
+    for (int g = 0; g < ghostsPerGame; g++) {
+        ghostStartX.push_back(ghosts.startPosition[g].x);
+        ghostStartY.push_back(ghosts.startPosition[g].y);
+        ghostType.push_back(ghosts.type[g]);
+    }
+    ghostRadius = PacmanCore::GHOST_RADIUS;
+
+    const auto& player = level.GetPlayer();
+    playerStart = player.startPosition;
+    playerSpeed = player.speed;
+    speeds = level.GetSpeeds();
+    playerRadius = player.radius;
+
+    float right = (float)grid.width - 1, bottom = (float)grid.height - 1;
+    scatterTiles[PacmanCore::BLINKY] = { right, 0 };
+    scatterTiles[PacmanCore::PINKY]  = { 0, 0 };
+    scatterTiles[PacmanCore::INKY]   = { right, bottom };
+    scatterTiles[PacmanCore::CLYDE]  = { 0, bottom };
+
+    size_t n = (size_t)gameCount, ng = n * ghostsPerGame;
+    playerX.assign(n, 0); playerY.assign(n, 0);
+    playerDirX.assign(n, 0); playerDirY.assign(n, 0); desiredDirX.assign(n, 0); desiredDirY.assign(n, 0);
+    ghostX.assign(ng, 0); ghostY.assign(ng, 0); ghostSpeed.assign(ng, 0); ghostTimer.assign(ng, 0);
+    ghostDirX.assign(ng, 0); ghostDirY.assign(ng, 0); ghostState.assign(ng, 0);
+    pelletBits.assign(n * pelletWords, 0);
+    score.assign(n, 0); lives.assign(n, 0); activePellets.assign(n, 0); ghostsEatenThisPowerup.assign(n, 0);
+    roundState.assign(n, 0); roundTimer.assign(n, 0);
+    rewards.assign(n, 0); dones.assign(n, 0); gamesFinished.assign(n, 0);
+
+    pool.reset(new ThreadPool(threadCount));
+    ResetAll();
+    return true;
+}
+
+void PacmanBatch::ResetAll() {
+    for (int i = 0; i < gameCount; i++) ResetGame(i);
+}
+
+void PacmanBatch::ResetGame(int game) {
+    lives[game] = 3;
+    score[game] = 0;
+    activePellets[game] = startPelletCount;
+    std::copy(startPelletBits.begin(), startPelletBits.end(), pelletBits.begin() + (size_t)game * pelletWords);
+
+    StartNewRound(game);
+}
+
+// Also used after a lost life; the two are identical in PacmanCore.
+void PacmanBatch::StartNewRound(int game) {
+    playerX[game] = playerStart.x;
+    playerY[game] = playerStart.y;
+    playerDirX[game] = playerDirY[game] = 0;
+    desiredDirX[game] = desiredDirY[game] = 0;
+
+    for (int g = 0; g < ghostsPerGame; g++) {
+        size_t i = (size_t)game * ghostsPerGame + g;
+        ghostX[i] = ghostStartX[g];
+        ghostY[i] = ghostStartY[g];
+        ghostState[i] = PacmanCore::CHASING;
+        ghostSpeed[i] = speeds.ghost;
+        ghostDirX[i] = -1;
+        ghostDirY[i] = 0;
+    }
+
+    roundState[game] = PacmanCore::READY;
+    roundTimer[game] = PacmanCore::READY_TICKS;
+}
+
+//----------------------------------------------------------------------------------
+// Rules
+//----------------------------------------------------------------------------------
+
+uint16_t PacmanBatch::TileDistance(Vec2 fromTile, Vec2 toTile) const {
+    int fx = (int)fromTile.x, fy = (int)fromTile.y;
+    if (!grid.InBounds(fx, fy)) return TileDistanceTable::UNREACHABLE;
+    int from = table.tileToOpen[grid.Index(fx, fy)];
+    int to = table.NearestOpenTile(grid, (int)toTile.x, (int)toTile.y);
+    if (from < 0 || to < 0) return TileDistanceTable::UNREACHABLE;
+    return table.FullTableDistance(from, table.tileToOpen[to]);
+}
+
+Vec2 PacmanBatch::GhostTargetTile(int game, int ghost) const {
+    size_t i = (size_t)game * ghostsPerGame + ghost;
+    size_t blinky = (size_t)game * ghostsPerGame; // Ghost 0 is always a Blinky
+    return PacmanCore::GhostTargetTile(ghostType[ghost], ghostState[i], PacmanCore::WorldToTile(FixVec2{ ghostX[i], ghostY[i] }),
+                                       PacmanCore::WorldToTile(FixVec2{ ghostStartX[ghost], ghostStartY[ghost] }),
+                                       PacmanCore::WorldToTile(FixVec2{ ghostX[blinky], ghostY[blinky] }),
+                                       PacmanCore::WorldToTile(FixVec2{ playerX[game], playerY[game] }),
+                                       FixVec2{ playerDirX[game], playerDirY[game] }, scatterTiles,
+                                       [this](Vec2 from, Vec2 to) { return TileDistance(from, to); });
+}
+
+void PacmanBatch::UpdatePlayer(int game) {
+    FixVec2 position = { playerX[game], playerY[game] };
+    FixVec2 direction = { playerDirX[game], playerDirY[game] };
+    PacmanCore::MovePlayer(position, direction, FixVec2{ desiredDirX[game], desiredDirY[game] }, playerSpeed, grid, maze);
+
+    playerX[game] = position.x;
+    playerY[game] = position.y;
+    playerDirX[game] = (int8_t)direction.x;
+    playerDirY[game] = (int8_t)direction.y;
+}
+
+void PacmanBatch::UpdateGhost(int game, int ghost) {
+    size_t i = (size_t)game * ghostsPerGame + ghost;
+
+    if (ghostState[i] == PacmanCore::FRIGHTENED && --ghostTimer[i] <= 0) {
+        ghostState[i] = PacmanCore::CHASING;
+        ghostSpeed[i] = speeds.ghost;
+    }
+
+    int tileX = PacmanCore::TileCoord(ghostX[i]), tileY = PacmanCore::TileCoord(ghostY[i]);
+    FixVec2 tileCenter = PacmanCore::TileCenter(tileX, tileY);
+
+    if (FixManhattan({ ghostX[i], ghostY[i] }, tileCenter) < ghostSpeed[i]) {
+        ghostX[i] = tileCenter.x;
+        ghostY[i] = tileCenter.y;
+
+        auto distance = [this](Vec2 from, Vec2 to) { return TileDistance(from, to); };
+        Vec2 homeTile = PacmanCore::WorldToTile(FixVec2{ ghostStartX[ghost], ghostStartY[ghost] });
+        if (ghostState[i] == PacmanCore::EATEN && PacmanCore::EyesRevive({ (float)tileX, (float)tileY }, homeTile, distance)) {
+            ghostState[i] = PacmanCore::CHASING;
+            ghostSpeed[i] = speeds.ghost;
+        }
+        FixVec2 direction = PacmanCore::ChooseGhostDirection(tileX, tileY, FixVec2{ ghostDirX[i], ghostDirY[i] }, grid, maze,
+                                                             [&] { return GhostTargetTile(game, ghost); }, distance);
+        ghostDirX[i] = (int8_t)direction.x;
+        ghostDirY[i] = (int8_t)direction.y;
+    }
+
+    ghostX[i] += ghostDirX[i] * ghostSpeed[i];
+    ghostY[i] += ghostDirY[i] * ghostSpeed[i];
+}
+
+// Only the 3x3 tiles around the player can hold a pellet close enough to touch, so this
+// reads at most nine bits, the same lookup as PacmanCore::Step().
+void PacmanBatch::EatPellets(int game) {
+    FixVec2 playerPos = { playerX[game], playerY[game] };
+    Vec2 playerTile = PacmanCore::WorldToTile(playerPos);
+    uint64_t* bits = &pelletBits[(size_t)game * pelletWords];
+
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int x = (int)playerTile.x + dx, y = (int)playerTile.y + dy;
+            if (!grid.InBounds(x, y)) continue;
+            int p = pelletAtTile[grid.Index(x, y)];
+            if (p < 0 || !((bits[p / 64] >> (p % 64)) & 1)) continue;
+            if (!FixCirclesOverlap(playerPos, playerRadius, { pelletX[p], pelletY[p] }, pelletRadius[p])) continue;
+
+            bits[p / 64] &= ~(1ull << (p % 64));
+            score[game] += pelletPoints[p];
+            activePellets[game]--;
+            if (pelletIsPower[p]) {
+                ghostsEatenThisPowerup[game] = 0;
+                for (int g = 0; g < ghostsPerGame; g++) {
+                    size_t i = (size_t)game * ghostsPerGame + g;
+                    if (ghostState[i] == PacmanCore::EATEN) continue;
+                    ghostState[i] = PacmanCore::FRIGHTENED;
+                    ghostTimer[i] = speeds.frightenedTicks;
+                    ghostSpeed[i] = speeds.frightened;
+                }
+            }
+        }
+    }
+}
+
+void PacmanBatch::StepGame(int game, PacAction action) {
+    int scoreBefore = score[game];
+    bool finished = false;
+
+    if (roundState[game] == PacmanCore::READY || roundState[game] == PacmanCore::PLAYING) {
+        FixVec2 desired = { desiredDirX[game], desiredDirY[game] };
+        PacmanCore::ApplyAction(action, desired);
+        desiredDirX[game] = (int8_t)desired.x;
+        desiredDirY[game] = (int8_t)desired.y;
+        UpdatePlayer(game);
+    }
+
+    switch (roundState[game]) {
+        case PacmanCore::READY: {
+            if (playerDirX[game] != 0 || playerDirY[game] != 0) roundState[game] = PacmanCore::PLAYING;
+        } break;
+
+        case PacmanCore::PLAYER_DYING: {
+            if (--roundTimer[game] <= 0) {
+                if (lives[game] <= 0) finished = true;
+                else StartNewRound(game);
+            }
+        } break;
+
+        case PacmanCore::PLAYING: {
+            for (int g = 0; g < ghostsPerGame; g++) UpdateGhost(game, g);
+
+            EatPellets(game);
+
+            FixVec2 playerPos = { playerX[game], playerY[game] };
+            for (int g = 0; g < ghostsPerGame; g++) {
+                size_t i = (size_t)game * ghostsPerGame + g;
+                if (!FixCirclesOverlap(playerPos, playerRadius, { ghostX[i], ghostY[i] }, ghostRadius)) continue;
+                if (ghostState[i] == PacmanCore::CHASING) {
+                    if (roundState[game] == PacmanCore::PLAYER_DYING) continue;  // As PacmanCore: one life per tick
+                    lives[game]--;
+                    roundState[game] = PacmanCore::PLAYER_DYING;
+                    roundTimer[game] = PacmanCore::DYING_TICKS;
+                } else if (ghostState[i] == PacmanCore::FRIGHTENED) {
+                    ghostsEatenThisPowerup[game]++;
+                    score[game] += PacmanCore::GhostEatPoints(ghostsEatenThisPowerup[game]);
+                    ghostState[i] = PacmanCore::EATEN;
+                    ghostSpeed[i] = speeds.eaten;
+                }
+            }
+
+            if (activePellets[game] <= 0) finished = true;
+        } break;
+    }
+
+    rewards[game] = score[game] - scoreBefore;
+    dones[game] = finished ? 1 : 0;
+    if (finished) {
+        gamesFinished[game]++;
+        ResetGame(game);
+    }
+}
+
+void PacmanBatch::Step(const uint8_t* actions) {
+    pool->ParallelFor(gameCount, [&](int begin, int end) {
+        for (int game = begin; game < end; game++) StepGame(game, (PacAction)actions[game]);
+    }, 64);
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************************
+*
+* pacman_batch.h - Many independent Pac-Man games stepped together
+*
+* A training environment built on the PacmanCore rules. Instead of one object per game, all
+* N games live in flat structure-of-arrays storage (player and ghost positions, directions,
+* ghost states and timers, one pellet bitset per game), and Step() advances every game by
+* one tick, spread across a thread pool. A game that ends is reset in place and reports
+* done = 1 for that step.
+*
+*     PacmanCore level;
+*     level.LoadLevel("level.txt");
+*     PacmanBatch batch;
+*     batch.Init(level, 4096);
+*     std::vector<uint8_t> actions(4096, ACTION_LEFT);
+*     batch.Step(actions.data());   // batch.rewards[i], batch.dones[i], batch.playerX[i] ...
+*
+* Needs a level whose distance table is a full table (not lazy), so every thread can read
+* it without locking.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pacman_core.h"
+#include "thread_pool.h"
+#include <memory>
+
+class PacmanBatch {
+public:
+    // Copies the static level data out of 'level' and starts gameCount fresh games.
+    // threadCount 0 uses every hardware thread.
+    bool Init(const PacmanCore& level, int gameCount, int threadCount = 0);
+
+    void ResetAll();
+    void ResetGame(int game);
+
+    // actions: one PacAction per game.
+    void Step(const uint8_t* actions);
+
+    int GetGameCount() const { return gameCount; }
+    int GetGhostsPerGame() const { return ghostsPerGame; }
+    int GetPelletsPerGame() const { return pelletCount; }
+    int GetPelletWordsPerGame() const { return pelletWords; }
+    int GetThreadCount() const { return pool ? pool->GetThreadCount() : 1; }
+
+    bool IsPelletActive(int game, int pellet) const {
+        return (pelletBits[(size_t)game * pelletWords + pellet / 64] >> (pellet % 64)) & 1;
+    }
+
+    //----------------------------------------------------------------------------------
+    // Per-game state, structure-of-arrays. Read freely; only Step()/Reset*() write it.
+    //----------------------------------------------------------------------------------
+
+    // Player, indexed by game. Positions and speeds are PacmanCore fixed-point units, timers
+    // are ticks.
+    std::vector<int32_t> playerX, playerY;
+    std::vector<int8_t> playerDirX, playerDirY, desiredDirX, desiredDirY;
+
+    // Ghosts, indexed by game * GetGhostsPerGame() + ghost
+    std::vector<int32_t> ghostX, ghostY, ghostSpeed, ghostTimer;
+    std::vector<int8_t> ghostDirX, ghostDirY;
+    std::vector<uint8_t> ghostState;   // PacmanCore::GhostState
+
+    // Pellets, GetPelletWordsPerGame() words per game, bit set = not eaten yet
+    std::vector<uint64_t> pelletBits;
+
+    // Round state, indexed by game
+    std::vector<int32_t> score, lives, activePellets, ghostsEatenThisPowerup;
+    std::vector<uint8_t> roundState;   // PacmanCore::RoundState
+    std::vector<int32_t> roundTimer;
+
+    // Results of the last Step(), indexed by game
+    std::vector<int32_t> rewards;
+    std::vector<uint8_t> dones;
+    std::vector<uint64_t> gamesFinished;
+
+private:
+    // Static level data shared by every game
+    TileGrid grid;
+    TileDistanceTable table;
+    MazeAnalysis maze;
+    std::vector<int> pelletAtTile;           // grid index -> pellet index, -1 if none
+    std::vector<int32_t> pelletX, pelletY, pelletRadius;
+    std::vector<int32_t> pelletPoints;
+    std::vector<uint64_t> startPelletBits;   // Reachable pellets, the bits every game starts with
+    int startPelletCount = 0;
+    std::vector<uint8_t> pelletIsPower;
+    std::vector<int32_t> ghostStartX, ghostStartY;
+    std::vector<uint8_t> ghostType;
+    FixVec2 playerStart = {0, 0};
+    Vec2 scatterTiles[4];
+    int32_t playerSpeed = PacmanCore::PLAYER_SPEED, playerRadius = 0, ghostRadius = PacmanCore::GHOST_RADIUS;
+    PacmanCore::Speeds speeds;
+
+    int gameCount = 0, ghostsPerGame = 0, pelletCount = 0, pelletWords = 0;
+    std::unique_ptr<ThreadPool> pool;
+
+    void StartNewRound(int game);
+    void StepGame(int game, PacAction action);
+    void UpdatePlayer(int game);
+    void UpdateGhost(int game, int ghost);
+    Vec2 GhostTargetTile(int game, int ghost) const;
+    uint16_t TileDistance(Vec2 fromTile, Vec2 toTile) const;
+    void EatPellets(int game);
+};
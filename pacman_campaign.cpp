@@ -0,0 +1,160 @@
+/*******************************************************************************************
+*
+* pacman_campaign.cpp - Level sequences and background level loading (see pacman_campaign.h)
+*
+********************************************************************************************/
+#include "pacman_campaign.h"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static constexpr char MAZE_PREFIX[] = "maze:";
+static constexpr size_t MAZE_PREFIX_LENGTH = sizeof(MAZE_PREFIX) - 1;
+
+static int32_t PixelsToUnits(float pixels) {
+    return (int32_t)std::lround(pixels * PacmanCore::SUBPIXELS);
+}
+
+//----------------------------------------------------------------------------------
+// Campaign File
+//----------------------------------------------------------------------------------
+
+bool LoadCampaign(const char* fileName, std::vector<CampaignLevel>& levels) {
+    levels.clear();
+    std::ifstream file(fileName);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        CampaignLevel level;
+        float player, ghost, frightened, eaten, frightenedSeconds;
+        if (!(fields >> level.source)) continue;
+        if (!(fields >> player >> ghost >> frightened >> eaten >> frightenedSeconds)) continue;
+
+        level.speeds.player = PixelsToUnits(player);
+        level.speeds.ghost = PixelsToUnits(ghost);
+        level.speeds.frightened = PixelsToUnits(frightened);
+        level.speeds.eaten = PixelsToUnits(eaten);
+        level.speeds.frightenedTicks = (int32_t)std::lround(frightenedSeconds * PacmanCore::TICK_RATE);
+        levels.push_back(level);
+    }
+    return !levels.empty();
+}
+
+bool IsCampaignFile(const std::string& source) {
+    return source.compare(0, MAZE_PREFIX_LENGTH, MAZE_PREFIX) != 0;
+}
+
+bool LoadCampaignLevel(const CampaignLevel& level, PacmanCore& game) {
+    bool loaded;
+    if (IsCampaignFile(level.source)) {
+        loaded = game.LoadLevel(level.source.c_str());
+    } else {
+        int width = 0, height = 0;
+        unsigned seed = 0;
+        if (std::sscanf(level.source.c_str() + MAZE_PREFIX_LENGTH, "%dx%d:%u", &width, &height, &seed) != 3) return false;
+        loaded = game.LoadLevelFromLines(GenerateMazeLines(width, height, seed));
+    }
+    if (loaded) game.SetSpeeds(level.speeds);
+    return loaded;
+}
+
+//----------------------------------------------------------------------------------
+// Preloader
+//----------------------------------------------------------------------------------
+
+void LevelPreloader::Request(const CampaignLevel& level, int index) {
+#ifdef PACMAN_CAMPAIGN_INLINE
+    readyIndex.store(-1, std::memory_order_release);
+    failedIndex.store(-1, std::memory_order_release);
+    auto loadStart = std::chrono::steady_clock::now();
+    loaded = PacmanCore();
+    bool ok = LoadCampaignLevel(level, loaded);
+    lastLoadMs.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count());
+    (ok ? readyIndex : failedIndex).store(index, std::memory_order_release);
+#else
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyIndex.store(-1, std::memory_order_release);
+        failedIndex.store(-1, std::memory_order_release);
+        pendingLevel = level;
+        pendingIndex = index;
+        requestGeneration++;
+        hasRequest = true;
+        stopping = false;
+    }
+    if (!thread.joinable()) thread = std::thread(&LevelPreloader::WorkerLoop, this);
+    wake.notify_one();
+#endif
+}
+
+bool LevelPreloader::Take(int index, PacmanCore& game) {
+    if (!IsReady(index)) return false;
+#ifdef PACMAN_CAMPAIGN_INLINE
+    std::swap(game, loaded);
+    loaded = PacmanCore();
+#else
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !IsReady(index)) return false;
+    std::swap(game, loaded);
+    hasDiscard = true;
+    lock.unlock();
+    wake.notify_one();
+#endif
+    readyIndex.store(-1, std::memory_order_release);
+    return true;
+}
+
+void LevelPreloader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+void LevelPreloader::WorkerLoop() {
+    for (;;) {
+        PacmanCore discard;
+        CampaignLevel level;
+        int index;
+        unsigned generation;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || hasRequest || hasDiscard; });
+            if (stopping) return;
+            if (hasDiscard) {
+                std::swap(discard, loaded);
+                hasDiscard = false;
+            }
+            if (!hasRequest) continue; // Only freeing; 'discard' goes out of scope here
+            level = pendingLevel;
+            index = pendingIndex;
+            generation = requestGeneration;
+            hasRequest = false;
+        }
+        discard = PacmanCore();
+
+        auto loadStart = std::chrono::steady_clock::now();
+        PacmanCore next;
+        bool ok = LoadCampaignLevel(level, next);
+        lastLoadMs.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count(),
+                         std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (generation != requestGeneration) continue; // Superseded while loading
+        if (ok) {
+            std::swap(loaded, next); // Whatever 'loaded' held is freed with 'next', after unlocking
+            readyIndex.store(index, std::memory_order_release);
+        } else {
+            failedIndex.store(index, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************************
+*
+* pacman_campaign.h - Level sequences with per-level speeds, loaded ahead on a worker thread
+*
+* A campaign file lists the levels in order, one per line, with the speeds to play them at.
+* Speeds are in pixels per tick and the frightened time in seconds; '#' starts a comment:
+*
+*     # level           player  ghost  frightened  eaten  frightened_s
+*     level.txt         2.8     2.0    1.5         4.0    7
+*     maze:41x41:7      3.0     2.4    1.6         4.0    5
+*
+* "maze:WxH:seed" is a GenerateMazeLines() maze instead of a file.
+*
+* Loading a level (parsing or mapping the compiled file, the distance table, the maze
+* analysis) takes far longer than a frame on big mazes, so LevelPreloader does it on its own
+* thread while the current level is played. Take() swaps the finished core in, which only
+* moves a handful of pointers; the replaced level is freed back on the worker:
+*
+*     preloader.Request(campaign[next], next);   // as soon as a level starts
+*     ...
+*     if (preloader.Take(next, game)) ...        // at level clear; false = not done yet
+*
+* Web builds without pthreads load inside Request() instead.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pacman_core.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define PACMAN_CAMPAIGN_INLINE
+#endif
+
+struct CampaignLevel {
+    std::string source;          // Level file, or "maze:WxH:seed"
+    PacmanCore::Speeds speeds;
+};
+
+// Returns false if the file can't be read or lists no levels. Malformed lines are skipped.
+bool LoadCampaign(const char* fileName, std::vector<CampaignLevel>& levels);
+
+// Loads the level's map into 'game' and applies its speeds. Needs nothing but the core, so
+// it is safe on any thread that owns 'game'.
+bool LoadCampaignLevel(const CampaignLevel& level, PacmanCore& game);
+
+// True if 'source' names a file (as opposed to a generated maze).
+bool IsCampaignFile(const std::string& source);
+
+class LevelPreloader {
+public:
+    LevelPreloader() = default;
+    ~LevelPreloader() { Stop(); }
+    LevelPreloader(const LevelPreloader&) = delete;
+    LevelPreloader& operator=(const LevelPreloader&) = delete;
+
+    // Starts loading 'level' in the background, replacing any earlier request. 'index' is
+    // only a tag for IsReady() and Take().
+    void Request(const CampaignLevel& level, int index);
+
+    bool IsReady(int index) const { return readyIndex.load(std::memory_order_acquire) == index; }
+    bool HasFailed(int index) const { return failedIndex.load(std::memory_order_acquire) == index; }
+
+    // Swaps the preloaded level into 'game' if it is ready. Never waits: returns false if
+    // the worker is still busy, and the caller tries again next frame.
+    bool Take(int index, PacmanCore& game);
+
+    void Stop();
+
+    double GetLastLoadMs() const { return lastLoadMs.load(std::memory_order_relaxed); }
+
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    // Guarded by 'mutex'
+    CampaignLevel pendingLevel;
+    int pendingIndex = -1;
+    unsigned requestGeneration = 0;
+    bool hasRequest = false;
+    bool hasDiscard = false;  // 'loaded' holds a level Take() swapped out, to free
+    bool stopping = false;
+    PacmanCore loaded;
+
+    std::atomic<int> readyIndex{-1}, failedIndex{-1};
+    std::atomic<double> lastLoadMs{0.0};
+
+    void WorkerLoop();
+};
@@ -0,0 +1,609 @@
+/*******************************************************************************************
+*
+* pacman_core.cpp - Headless Pac-Man simulation (see pacman_core.h)
+*
+********************************************************************************************/
+#include "pacman_core.h"
+#include "embedded_levels.h"
+#include <cstring>
+
+//----------------------------------------------------------------------------------
+// Level Loading
+//----------------------------------------------------------------------------------
+
+bool PacmanCore::LoadLevel(const char* fileName) {
+    LevelData level;
+    std::string name = fileName;
+    bool compiled = name.size() > 5 && name.compare(name.size() - 5, 5, ".lvlc") == 0;
+
+    bool loaded = compiled ? LoadCompiledLevel(fileName, level) : LoadLevelCached(fileName, level, "level_cache", &lastLoadCached);
+    lastLoadEmbedded = false;
+    if (!loaded) {
+        const EmbeddedLevelView* embedded = FindEmbeddedLevel(fileName);
+        if (!embedded) {
+            mapLoaded = false;
+            return false;
+        }
+        embedded->ToLevelData(level);
+        lastLoadEmbedded = true;
+        lastLoadCached = false;
+    }
+    if (compiled) lastLoadCached = true;
+    return LoadLevelData(level);
+}
+
+bool PacmanCore::LoadLevelFromLines(const std::vector<std::string>& lines) {
+    std::string text;
+    for (const auto& line : lines) {
+        text += line;
+        text += '\n';
+    }
+    LevelData level;
+    ParseLevelText(text.data(), text.size(), level);
+    lastLoadCached = false;
+    lastLoadEmbedded = false;
+    return LoadLevelData(level);
+}
+
+void PacmanCore::PelletArrays::Clear() {
+    position.clear(); radius.clear(); isPowerPellet.clear();
+}
+
+void PacmanCore::PelletArrays::Reserve(size_t count) {
+    position.reserve(count); radius.reserve(count); isPowerPellet.reserve(count);
+}
+
+void PacmanCore::PelletArrays::Add(FixVec2 at, bool power) {
+    position.push_back(at);
+    radius.push_back(power ? POWER_PELLET_RADIUS : PELLET_RADIUS);
+    isPowerPellet.push_back(power ? 1 : 0);
+}
+
+void PacmanCore::GhostArrays::Clear() {
+    position.clear(); prevPosition.clear(); startPosition.clear(); direction.clear();
+    type.clear(); state.clear(); stateTicks.clear(); speed.clear();
+}
+
+void PacmanCore::GhostArrays::Add(FixVec2 start) {
+    type.push_back((uint8_t)(Count() % 4));
+    position.push_back(start);
+    prevPosition.push_back(start);
+    startPosition.push_back(start);
+    direction.push_back({ -1, 0 });
+    state.push_back(CHASING);
+    stateTicks.push_back(0);
+    speed.push_back(0); // Set by ResetGhosts()
+}
+
+bool PacmanCore::LoadLevelData(const LevelData& level) {
+    pellets.Clear();
+    ghosts.Clear();
+    ghostHashActive = false;
+    player = Player();
+
+    grid.width = level.width;
+    grid.height = level.height;
+    grid.walls = level.walls;
+    grid.exits = level.exits;
+
+    if (level.hasPlayer) maze.Build(grid, level.player.x, level.player.y);
+    else maze.Build(grid, -1, -1);
+
+    pellets.Reserve(level.pellets.size());
+    pelletAtTile.assign((size_t)grid.width * grid.height, -1);
+    reachablePelletBits.assign((level.pellets.size() + 63) / 64, 0);
+    reachablePelletCount = 0;
+    for (const auto& p : level.pellets) {
+        FixVec2 pos = TileCenter(p.x, p.y);
+        int index = pellets.Count();
+        if (grid.InBounds(p.x, p.y)) pelletAtTile[grid.Index(p.x, p.y)] = index;
+        if (maze.IsReachable(p.x, p.y)) {
+            reachablePelletBits[index >> 6] |= 1ull << (index & 63);
+            reachablePelletCount++;
+        }
+        pellets.Add(pos, p.isPowerPellet);
+    }
+    levelGhostStarts.clear();
+    for (const auto& g : level.ghosts) levelGhostStarts.push_back(TileCenter(g.x, g.y));
+    for (FixVec2 start : levelGhostStarts) ghosts.Add(start);
+    if (level.hasPlayer) player.startPosition = TileCenter(level.player.x, level.player.y);
+
+    RefillPellets();
+    distanceTable.Build(grid);
+
+    std::vector<uint16_t> layout = { (uint16_t)level.width, (uint16_t)level.height, level.player.x, level.player.y };
+    for (const auto& p : level.pellets) layout.insert(layout.end(), { p.x, p.y, (uint16_t)p.isPowerPellet });
+    for (const auto& g : level.ghosts) layout.insert(layout.end(), { g.x, g.y });
+    layoutHash = HashBytes(layout.data(), layout.size() * sizeof(uint16_t), HashBytes(grid.walls.data(), grid.walls.size()));
+    levelHash = HashBytes(&speeds, sizeof(speeds), layoutHash);
+    player.speed = speeds.player;
+
+    float right = (float)grid.width - 1, bottom = (float)grid.height - 1;
+    scatterTiles[BLINKY] = { right, 0 };
+    scatterTiles[PINKY]  = { 0, 0 };
+    scatterTiles[INKY]   = { right, bottom };
+    scatterTiles[CLYDE]  = { 0, bottom };
+
+    mapLoaded = grid.width > 0 && grid.height > 0;
+    RebuildZobrist();
+    return mapLoaded;
+}
+
+void PacmanCore::SpawnGhostSwarm(int count, unsigned seed) {
+    if (!mapLoaded) return;
+    if (count <= 0) {
+        ghosts.Clear();
+        ghostHashActive = false;
+        for (FixVec2 start : levelGhostStarts) ghosts.Add(start);
+        RebuildZobrist();
+        return;
+    }
+
+    // Anywhere open, as long as it isn't right on top of the player
+    Vec2 startTile = WorldToTile(player.startPosition);
+    std::vector<int> spawnTiles;
+    for (int y = 0; y < grid.height; y++) {
+        for (int x = 0; x < grid.width; x++) {
+            if (grid.IsWall(x, y) || std::abs(x - (int)startTile.x) + std::abs(y - (int)startTile.y) < 8) continue;
+            spawnTiles.push_back(grid.Index(x, y));
+        }
+    }
+    if (spawnTiles.empty()) return;
+
+    std::mt19937 rng(seed);
+    ghosts.Clear();
+    ghostHashActive = false;
+    for (int i = 0; i < count; i++) {
+        int tile = spawnTiles[rng() % spawnTiles.size()];
+        ghosts.Add(TileCenter(tile % grid.width, tile / grid.width));
+    }
+    RebuildZobrist();
+}
+
+//----------------------------------------------------------------------------------
+// Round Control
+//----------------------------------------------------------------------------------
+
+void PacmanCore::SetSpeeds(const Speeds& newSpeeds) {
+    speeds = newSpeeds;
+    speeds.player = std::clamp(speeds.player, 1, MAX_SPEED);
+    speeds.ghost = std::clamp(speeds.ghost, 1, MAX_SPEED);
+    speeds.frightened = std::clamp(speeds.frightened, 1, MAX_SPEED);
+    speeds.eaten = std::clamp(speeds.eaten, 1, MAX_SPEED);
+    speeds.frightenedTicks = std::max(speeds.frightenedTicks, 1);
+    player.speed = speeds.player;
+    levelHash = HashBytes(&speeds, sizeof(speeds), layoutHash);
+    RebuildZobrist(); // Keys derive from the level hash
+}
+
+void PacmanCore::Reset(int lives, int startScore) {
+    if (!mapLoaded) return;
+
+    playerLives = lives;
+    score = startScore;
+    gameOver = false;
+    victory = false;
+
+    RefillPellets();
+
+    StartNewRound();
+    RebuildZobrist();
+}
+
+void PacmanCore::RefillPellets() {
+    activePellets = reachablePelletCount;
+    pelletBits = reachablePelletBits;
+}
+
+void PacmanCore::StartNewRound() {
+    player.position = player.startPosition;
+    player.direction = {0, 0};
+    player.desiredDirection = {0, 0};
+    RehashPlayer();
+    ResetGhosts();
+
+    roundState = READY;
+    roundStateTicks = READY_TICKS;
+    SnapInterpolation();
+}
+
+void PacmanCore::ResetGhosts() {
+    ghosts.position = ghosts.startPosition;
+    std::fill(ghosts.state.begin(), ghosts.state.end(), (uint8_t)CHASING);
+    std::fill(ghosts.speed.begin(), ghosts.speed.end(), speeds.ghost);
+    std::fill(ghosts.direction.begin(), ghosts.direction.end(), FixVec2{ -1, 0 });
+    for (int g = 0; g < ghosts.Count() && zobristActive; g++) RehashGhost(g);
+
+    ghostHashActive = ghosts.Count() >= SPATIAL_HASH_MIN_GHOSTS;
+    if (ghostHashActive) {
+        ghostHash.Reset(ghosts.Count(), TILE_UNITS * 2);
+        for (int g = 0; g < ghosts.Count(); g++) ghostHash.Update(g, (float)ghosts.position[g].x, (float)ghosts.position[g].y);
+    }
+}
+
+// Stop the renderer from blending across a teleport (round reset, tunnel wrap).
+void PacmanCore::SnapInterpolation() {
+    player.prevPosition = player.position;
+    ghosts.prevPosition = ghosts.position;
+}
+
+//----------------------------------------------------------------------------------
+// Snapshots
+//----------------------------------------------------------------------------------
+
+// Fixed-size copies only: no allocation, and the cost is a few hundred bytes of memcpy.
+bool PacmanCore::SaveSnapshot(Snapshot& out) const {
+    if (!mapLoaded || !CanSnapshot()) return false;
+    int n = ghosts.Count();
+
+    out.player = player;
+    memcpy(out.ghostPosition, ghosts.position.data(), n * sizeof(FixVec2));
+    memcpy(out.ghostPrevPosition, ghosts.prevPosition.data(), n * sizeof(FixVec2));
+    memcpy(out.ghostDirection, ghosts.direction.data(), n * sizeof(FixVec2));
+    memcpy(out.ghostStateTicks, ghosts.stateTicks.data(), n * sizeof(int32_t));
+    memcpy(out.ghostSpeed, ghosts.speed.data(), n * sizeof(int32_t));
+    memcpy(out.ghostState, ghosts.state.data(), n);
+    memcpy(out.pelletBits, pelletBits.data(), pelletBits.size() * sizeof(uint64_t));
+    out.levelHash = levelHash;
+    out.ghostCount = n;
+    out.pelletCount = pellets.Count();
+    out.playerLives = playerLives;
+    out.score = score;
+    out.activePellets = activePellets;
+    out.ghostsEatenThisPowerup = ghostsEatenThisPowerup;
+    out.roundStateTicks = roundStateTicks;
+    out.roundState = (uint8_t)roundState;
+    out.gameOver = gameOver;
+    out.victory = victory;
+    out.zobristHash = zobristHash;
+    out.playerZobristCell = playerZobristCell;
+    memcpy(out.ghostZobristCell, ghostZobristCell.data(), n * sizeof(uint32_t));
+    return true;
+}
+
+bool PacmanCore::RestoreSnapshot(const Snapshot& in) {
+    if (!mapLoaded || in.levelHash != levelHash || in.ghostCount != ghosts.Count() || in.pelletCount != pellets.Count()) return false;
+    int n = in.ghostCount;
+
+    player = in.player;
+    memcpy(ghosts.position.data(), in.ghostPosition, n * sizeof(FixVec2));
+    memcpy(ghosts.prevPosition.data(), in.ghostPrevPosition, n * sizeof(FixVec2));
+    memcpy(ghosts.direction.data(), in.ghostDirection, n * sizeof(FixVec2));
+    memcpy(ghosts.stateTicks.data(), in.ghostStateTicks, n * sizeof(int32_t));
+    memcpy(ghosts.speed.data(), in.ghostSpeed, n * sizeof(int32_t));
+    memcpy(ghosts.state.data(), in.ghostState, n);
+    memcpy(pelletBits.data(), in.pelletBits, pelletBits.size() * sizeof(uint64_t));
+    playerLives = in.playerLives;
+    score = in.score;
+    activePellets = in.activePellets;
+    ghostsEatenThisPowerup = in.ghostsEatenThisPowerup;
+    roundStateTicks = in.roundStateTicks;
+    roundState = (RoundState)in.roundState;
+    gameOver = in.gameOver != 0;
+    victory = in.victory != 0;
+    zobristHash = zobristActive ? in.zobristHash : 0;
+    playerZobristCell = in.playerZobristCell;
+    memcpy(ghostZobristCell.data(), in.ghostZobristCell, n * sizeof(uint32_t));
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Zobrist Hashing
+//----------------------------------------------------------------------------------
+
+// Keys are derived on demand (splitmix64 of the level seed, entity kind and cell) instead
+// of stored in tables, so any level size works without a table per tile.
+uint64_t PacmanCore::ZobristKey(uint64_t kind, uint64_t value) const {
+    uint64_t z = levelHash + kind * 0x9E3779B97F4A7C15ull + value * 0xD1B54A32D192ED03ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint32_t PacmanCore::PlayerZobristCell() const {
+    return (uint32_t)(TileCoord(player.position.y) * grid.width + TileCoord(player.position.x));
+}
+
+uint32_t PacmanCore::GhostZobristCell(int ghost) const {
+    FixVec2 position = ghosts.position[ghost];
+    return (uint32_t)(TileCoord(position.y) * grid.width + TileCoord(position.x)) << 2 | ghosts.state[ghost];
+}
+
+uint64_t PacmanCore::ComputeZobristHash() const {
+    if (!zobristActive) return 0;
+    uint64_t hash = ZobristKey(0, PlayerZobristCell());
+    for (int g = 0; g < ghosts.Count(); g++) hash ^= ZobristKey(1 + g, GhostZobristCell(g));
+    for (int i = 0; i < pellets.Count(); i++) {
+        if (IsPelletActive(i)) hash ^= ZobristKey(~0ull, i);
+    }
+    return hash;
+}
+
+void PacmanCore::RebuildZobrist() {
+    zobristActive = zobristEnabled && mapLoaded && CanSnapshot();
+    playerZobristCell = PlayerZobristCell();
+    ghostZobristCell.resize(ghosts.Count());
+    for (int g = 0; g < ghosts.Count(); g++) ghostZobristCell[g] = GhostZobristCell(g);
+    zobristHash = ComputeZobristHash();
+}
+
+void PacmanCore::SetZobristEnabled(bool enabled) {
+    zobristEnabled = enabled;
+    RebuildZobrist();
+}
+
+void PacmanCore::RehashPlayer() {
+    if (!zobristActive) return;
+    uint32_t cell = PlayerZobristCell();
+    if (cell == playerZobristCell) return;
+    zobristHash ^= ZobristKey(0, playerZobristCell) ^ ZobristKey(0, cell);
+    playerZobristCell = cell;
+}
+
+void PacmanCore::RehashGhost(int ghost) {
+    uint32_t cell = GhostZobristCell(ghost);
+    if (cell == ghostZobristCell[ghost]) return;
+    zobristHash ^= ZobristKey(1 + ghost, ghostZobristCell[ghost]) ^ ZobristKey(1 + ghost, cell);
+    ghostZobristCell[ghost] = cell;
+}
+
+//----------------------------------------------------------------------------------
+// Ghost Targeting
+//----------------------------------------------------------------------------------
+
+uint16_t PacmanCore::TileDistance(Vec2 fromTile, Vec2 toTile) {
+    return distanceTable.Distance(grid, (int)fromTile.x, (int)fromTile.y, (int)toTile.x, (int)toTile.y);
+}
+
+Vec2 PacmanCore::GhostTargetTile(int ghost) {
+    Vec2 blinkyTile = WorldToTile(ghosts.position[0]); // Ghost 0 is always a Blinky
+    return GhostTargetTile(ghosts.type[ghost], ghosts.state[ghost], WorldToTile(ghosts.position[ghost]),
+                           WorldToTile(ghosts.startPosition[ghost]), blinkyTile, WorldToTile(player.position),
+                           player.direction, scatterTiles, [this](Vec2 from, Vec2 to) { return TileDistance(from, to); });
+}
+
+//----------------------------------------------------------------------------------
+// Simulation Step
+//----------------------------------------------------------------------------------
+
+void PacmanCore::ApplyAction(PacAction action, FixVec2& desiredDirection) {
+    switch (action) {
+        case ACTION_UP:    desiredDirection = { 0, -1 }; break;
+        case ACTION_DOWN:  desiredDirection = { 0, 1 }; break;
+        case ACTION_LEFT:  desiredDirection = { -1, 0 }; break;
+        case ACTION_RIGHT: desiredDirection = { 1, 0 }; break;
+        default: break;
+    }
+}
+
+// Entities only turn or stop exactly on a tile centre. They move along the centre lines, so
+// the Manhattan distance to the centre is the real distance and no square root is needed.
+// The player follows the maze analysis exits, which include tunnels: leaving the map through
+// one wraps it to the matching mouth on the opposite edge.
+bool PacmanCore::MovePlayer(FixVec2& position, FixVec2& direction, FixVec2 desiredDirection, int32_t speed,
+                            const TileGrid& grid, const MazeAnalysis& maze) {
+    int tileX = TileCoord(position.x), tileY = TileCoord(position.y);
+    FixVec2 tileCenter = TileCenter(tileX, tileY);
+    bool nearCenter = FixManhattan(position, tileCenter) < speed;
+    uint8_t exits = maze.Exits(tileX, tileY);
+
+    if (exits & DirectionExit(desiredDirection.x, desiredDirection.y)) {
+        if (!FixEquals(desiredDirection, direction) && nearCenter) {
+            position = tileCenter;
+            direction = desiredDirection;
+        }
+    }
+
+    if (!(exits & DirectionExit(direction.x, direction.y)) && nearCenter) {
+        position = tileCenter;
+        direction = { 0, 0 };
+    }
+
+    position = FixAdd(position, FixScale(direction, speed));
+
+    int32_t mapWidth = grid.width * TILE_UNITS, mapHeight = grid.height * TILE_UNITS;
+    if (position.x < 0 || position.x >= mapWidth || position.y < 0 || position.y >= mapHeight) {
+        position.x = (position.x + mapWidth) % mapWidth;
+        position.y = (position.y + mapHeight) % mapHeight;
+        return true;
+    }
+    return false;
+}
+
+void PacmanCore::UpdatePlayer() {
+    if (MovePlayer(player.position, player.direction, player.desiredDirection, player.speed, grid, maze)) {
+        player.prevPosition = player.position; // Don't draw it sliding across the map
+    }
+}
+
+// Ghost 0 (always a Blinky) goes first, since Inky aims off its new position. No other ghost
+// depends on another's move, so the rest are stepped as passes over the ghost arrays: the
+// frightened timers, then the straight move of every ghost between tile centres (nearly all
+// of them on any tick), and only then the per-ghost decision for those that reached one.
+// Each pass streams through a few contiguous arrays with no calls or early exits, so the
+// compiler can vectorize it; the result is the same as stepping the ghosts one by one.
+void PacmanCore::UpdateGhosts() {
+    int count = ghosts.Count();
+    if (count > 0) UpdateGhost(0);
+
+    uint8_t* state = ghosts.state.data();
+    int32_t* stateTicks = ghosts.stateTicks.data();
+    int32_t* speed = ghosts.speed.data();
+    for (int g = 1; g < count; g++) {
+        int32_t frightened = state[g] == FRIGHTENED;
+        int32_t ticks = stateTicks[g] - frightened;
+        int32_t expired = frightened & (ticks <= 0);
+        stateTicks[g] = ticks;
+        state[g] = expired ? (uint8_t)CHASING : state[g];
+        speed[g] = expired ? speeds.ghost : speed[g];
+    }
+
+    ghostAtCenter.resize(count);
+    FixVec2* position = ghosts.position.data();
+    const FixVec2* direction = ghosts.direction.data();
+    uint8_t* atCenter = ghostAtCenter.data();
+    for (int g = 1; g < count; g++) {
+        // TileCenter(TileCoord(v)); positions are never left of -TILE_UNITS, so unsigned
+        // division (one multiply, vectorizable) gives the same tile
+        int32_t x = position[g].x, y = position[g].y;
+        int32_t centerX = (int32_t)((uint32_t)(x + TILE_UNITS) / TILE_UNITS) * TILE_UNITS - TILE_UNITS / 2;
+        int32_t centerY = (int32_t)((uint32_t)(y + TILE_UNITS) / TILE_UNITS) * TILE_UNITS - TILE_UNITS / 2;
+        int32_t arrived = std::abs(x - centerX) + std::abs(y - centerY) < speed[g];
+        int32_t step = speed[g] * (1 - arrived);
+        position[g].x = x + direction[g].x * step;
+        position[g].y = y + direction[g].y * step;
+        atCenter[g] = (uint8_t)arrived;
+    }
+    for (int g = 1; g < count; g++) {
+        if (atCenter[g]) MoveGhost(g);
+    }
+
+    if (zobristActive) {
+        for (int g = 0; g < count; g++) RehashGhost(g);
+    }
+}
+
+void PacmanCore::UpdateGhost(int ghost) {
+    if (ghosts.state[ghost] == FRIGHTENED && --ghosts.stateTicks[ghost] <= 0) {
+        ghosts.state[ghost] = CHASING;
+        ghosts.speed[ghost] = speeds.ghost;
+    }
+    MoveGhost(ghost);
+}
+
+void PacmanCore::MoveGhost(int ghost) {
+    FixVec2& position = ghosts.position[ghost];
+    FixVec2& direction = ghosts.direction[ghost];
+    uint8_t& state = ghosts.state[ghost];
+    int32_t& speed = ghosts.speed[ghost];
+
+    int tileX = TileCoord(position.x), tileY = TileCoord(position.y);
+    FixVec2 tileCenter = TileCenter(tileX, tileY);
+
+    if (FixManhattan(position, tileCenter) < speed) {
+        position = tileCenter;
+        if (ghostHashActive) ghostHash.Update(ghost, (float)position.x, (float)position.y);
+
+        auto distance = [this](Vec2 from, Vec2 to) { return TileDistance(from, to); };
+        if (state == EATEN && EyesRevive({ (float)tileX, (float)tileY }, WorldToTile(ghosts.startPosition[ghost]), distance)) {
+            state = CHASING;
+            speed = speeds.ghost;
+        }
+        direction = ChooseGhostDirection(tileX, tileY, direction, grid, maze, [&] { return GhostTargetTile(ghost); }, distance);
+    }
+    position = FixAdd(position, FixScale(direction, speed));
+}
+
+// Candidates are checked in index order, so with or without the spatial hash the outcome is
+// the same as testing every ghost in turn.
+void PacmanCore::CollideWithGhosts(PacStepResult& result) {
+    nearbyGhosts.clear();
+    if (ghostHashActive) {
+        float reach = (float)(player.radius + GHOST_RADIUS + GHOST_HASH_SLACK);
+        float x = (float)player.position.x, y = (float)player.position.y;
+        ghostHash.Query(x - reach, y - reach, x + reach, y + reach,
+                        [&](int g) { nearbyGhosts.push_back(g); });
+        std::sort(nearbyGhosts.begin(), nearbyGhosts.end());
+    } else {
+        for (int g = 0; g < ghosts.Count(); g++) nearbyGhosts.push_back(g);
+    }
+
+    for (int g : nearbyGhosts) {
+        if (!FixCirclesOverlap(player.position, player.radius, ghosts.position[g], GHOST_RADIUS)) continue;
+        if (ghosts.state[g] == CHASING) {
+            if (roundState == PLAYER_DYING) continue;  // One life per tick, however many ghosts touch
+            playerLives--;
+            roundState = PLAYER_DYING;
+            roundStateTicks = DYING_TICKS;
+            result.events |= EVENT_PLAYER_DIED;
+        } else if (ghosts.state[g] == FRIGHTENED) {
+            ghostsEatenThisPowerup++;
+            score += GhostEatPoints(ghostsEatenThisPowerup);
+            ghosts.state[g] = EATEN;
+            ghosts.speed[g] = speeds.eaten;
+            result.events |= EVENT_GHOST_EATEN;
+            if (zobristActive) RehashGhost(g);
+        }
+    }
+}
+
+PacStepResult PacmanCore::Step(PacAction action) {
+    PacStepResult result;
+    if (!mapLoaded || gameOver || victory) {
+        result.done = true;
+        return result;
+    }
+
+    player.prevPosition = player.position;
+    ghosts.prevPosition = ghosts.position;
+
+    if (roundState == READY || roundState == PLAYING) {
+        ApplyAction(action, player.desiredDirection);
+        UpdatePlayer();
+        RehashPlayer();
+    }
+
+    int scoreBefore = score;
+
+    switch (roundState) {
+        case READY: {
+            if (player.direction.x != 0 || player.direction.y != 0) {
+                roundState = PLAYING;
+            }
+        } break;
+
+        case PLAYER_DYING: {
+            if (--roundStateTicks <= 0) {
+                if (playerLives <= 0) {
+                    gameOver = true;
+                    result.events |= EVENT_GAME_OVER;
+                } else {
+                    StartNewRound();
+                }
+            }
+        } break;
+
+        case PLAYING: {
+            UpdateGhosts();
+
+            // Pellets sit on tile centres, so only the 3x3 tiles around the player can overlap it
+            Vec2 playerTile = WorldToTile(player.position);
+            for (int dy = -1; dy <= 1; dy++) for (int dx = -1; dx <= 1; dx++) {
+                int tx = (int)playerTile.x + dx, ty = (int)playerTile.y + dy;
+                if (!grid.InBounds(tx, ty) || pelletAtTile[grid.Index(tx, ty)] < 0) continue;
+                int index = pelletAtTile[grid.Index(tx, ty)];
+                if (IsPelletActive(index) && FixCirclesOverlap(player.position, player.radius, pellets.position[index], pellets.radius[index])) {
+                    pelletBits[index >> 6] &= ~(1ull << (index & 63));
+                    if (zobristActive) zobristHash ^= ZobristKey(~0ull, index);
+                    score += pellets.Points(index);
+                    activePellets--;
+                    result.events |= EVENT_PELLET;
+                    if (pellets.isPowerPellet[index]) {
+                        result.events |= EVENT_POWER_PELLET;
+                        ghostsEatenThisPowerup = 0;
+                        for (int g = 0; g < ghosts.Count(); g++) {
+                            if (ghosts.state[g] != EATEN) {
+                                ghosts.state[g] = FRIGHTENED;
+                                ghosts.stateTicks[g] = speeds.frightenedTicks;
+                                ghosts.speed[g] = speeds.frightened;
+                                if (zobristActive) RehashGhost(g);
+                            }
+                        }
+                    }
+                }
+            }
+
+            CollideWithGhosts(result);
+
+            if (activePellets <= 0) {
+                victory = true;
+                result.events |= EVENT_LEVEL_CLEARED;
+                StartNewRound();
+            }
+        } break;
+    }
+
+    result.reward = score - scoreBefore;
+    result.done = gameOver || victory;
+    return result;
+}
@@ -0,0 +1,421 @@
+/*******************************************************************************************
+*
+* pacman_core.h - Headless Pac-Man simulation
+*
+* The complete Pac-Man rules with no raylib, window, audio or input dependency. The
+* PacmanChannel in main.cpp feeds it keyboard input and draws the state it exposes; bots and
+* batch evaluations drive it directly:
+*
+*     PacmanCore game;
+*     game.LoadLevel("level.txt");
+*     game.Reset();
+*     while (!game.IsFinished()) {
+*         PacStepResult r = game.Step(ACTION_LEFT);
+*         // r.reward, r.events, game.GetPlayer(), game.GetGhosts() ...
+*     }
+*
+* Build as a library (no raylib needed):
+*     g++ -O2 -std=c++17 -c pacman_core.cpp level_file.cpp && ar rcs libpacman_core.a pacman_core.o level_file.o
+*
+********************************************************************************************/
+#pragma once
+
+#include "maze.h"
+#include "level_file.h"
+#include "spatial_hash.h"
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+// ---------- Math ----------
+// Same layout as raylib's Vector2 so the channel can convert for free.
+struct Vec2 { float x, y; };
+
+inline Vec2 Vec2Add(Vec2 a, Vec2 b) { return { a.x + b.x, a.y + b.y }; }
+inline Vec2 Vec2Subtract(Vec2 a, Vec2 b) { return { a.x - b.x, a.y - b.y }; }
+inline Vec2 Vec2Scale(Vec2 v, float s) { return { v.x * s, v.y * s }; }
+inline float Vec2LengthSqr(Vec2 v) { return v.x * v.x + v.y * v.y; }
+inline float Vec2Distance(Vec2 a, Vec2 b) { return std::sqrt(Vec2LengthSqr(Vec2Subtract(a, b))); }
+inline bool CirclesOverlap(Vec2 a, float ra, Vec2 b, float rb) { return Vec2LengthSqr(Vec2Subtract(a, b)) <= (ra + rb) * (ra + rb); }
+
+// Fixed-point simulation coordinates (PacmanCore::SUBPIXELS units per pixel). Entity
+// movement is all integer adds and compares, so every compiler and platform steps a game
+// to exactly the same state; only the renderer converts back to floats.
+struct FixVec2 { int32_t x, y; };
+
+inline FixVec2 FixAdd(FixVec2 a, FixVec2 b) { return { a.x + b.x, a.y + b.y }; }
+inline FixVec2 FixScale(FixVec2 v, int32_t s) { return { v.x * s, v.y * s }; }
+inline bool FixEquals(FixVec2 a, FixVec2 b) { return a.x == b.x && a.y == b.y; }
+inline int32_t FixManhattan(FixVec2 a, FixVec2 b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y); }
+inline bool FixCirclesOverlap(FixVec2 a, int32_t ra, FixVec2 b, int32_t rb) {
+    int64_t dx = a.x - b.x, dy = a.y - b.y, r = (int64_t)ra + rb;
+    return dx * dx + dy * dy <= r * r;
+}
+
+// ---------- Stepping API ----------
+// ACTION_NONE keeps the last requested direction, like letting go of the keys.
+enum PacAction { ACTION_NONE, ACTION_UP, ACTION_DOWN, ACTION_LEFT, ACTION_RIGHT, ACTION_COUNT };
+
+// Things that happened during a step, for sound effects or reward shaping.
+enum PacEvent : unsigned {
+    EVENT_PELLET        = 1 << 0,
+    EVENT_POWER_PELLET  = 1 << 1,
+    EVENT_GHOST_EATEN   = 1 << 2,
+    EVENT_PLAYER_DIED   = 1 << 3,
+    EVENT_LEVEL_CLEARED = 1 << 4,
+    EVENT_GAME_OVER     = 1 << 5,
+};
+
+struct PacStepResult {
+    int reward = 0;       // Points scored this step
+    unsigned events = 0;  // PacEvent bits
+    bool done = false;    // Game over or level cleared; call Reset() to play again
+};
+
+// ---------- PacmanCore ----------
+class PacmanCore {
+public:
+    static constexpr float TILE_SIZE = 24.0f;
+
+    // Positions, speeds and radii are FixVec2 units: 1/SUBPIXELS of a pixel, which makes
+    // every speed below an exact integer.
+    static constexpr int32_t SUBPIXELS = 20;
+    static constexpr int32_t TILE_UNITS = (int32_t)TILE_SIZE * SUBPIXELS;
+
+    // Speeds are units per tick and timers count ticks, so one Step() is always 1/60 s of
+    // game time no matter how fast it is called.
+    static constexpr float TICK_RATE = 60.0f;
+    static constexpr float TICK_DT = 1.0f / TICK_RATE;
+
+    // Default Speeds
+    static constexpr int32_t PLAYER_SPEED = 56;                   // 2.8 px
+    static constexpr int32_t GHOST_SPEED = 2 * SUBPIXELS;
+    static constexpr int32_t GHOST_FRIGHTENED_SPEED = 30;         // 1.5 px
+    static constexpr int32_t GHOST_EATEN_SPEED = 4 * SUBPIXELS;
+    static constexpr int FRIGHTENED_TICKS = 7 * 60;
+    static constexpr int32_t MAX_SPEED = TILE_UNITS / 2;          // Faster would step over tile centres
+
+    static constexpr int READY_TICKS = 2 * 60;
+    static constexpr int DYING_TICKS = 90;
+
+    static constexpr int32_t GHOST_RADIUS = TILE_UNITS / 2 - 2 * SUBPIXELS;
+    static constexpr int SPATIAL_HASH_MIN_GHOSTS = 256; // Below this a straight loop is cheaper
+
+    // Per-level difficulty, e.g. from a campaign file. Units per tick, clamped to MAX_SPEED.
+    struct Speeds {
+        int32_t player = PLAYER_SPEED;
+        int32_t ghost = GHOST_SPEED;
+        int32_t frightened = GHOST_FRIGHTENED_SPEED;
+        int32_t eaten = GHOST_EATEN_SPEED;
+        int32_t frightenedTicks = FRIGHTENED_TICKS;
+    };
+
+    enum GhostType { BLINKY, PINKY, INKY, CLYDE };
+    enum GhostState { CHASING, FRIGHTENED, EATEN };
+    enum RoundState { READY, PLAYING, PLAYER_DYING };
+
+    // Directions are unit steps: {0, -1} is up.
+    struct Player {
+        FixVec2 position, startPosition, direction = {0, 0}, desiredDirection = {0, 0};
+        int32_t speed = PLAYER_SPEED;
+        int32_t radius = TILE_UNITS / 2 - 2 * SUBPIXELS;
+        FixVec2 prevPosition = {0, 0}; // Position at the previous tick, for interpolation
+    };
+
+    // Ghosts in structure-of-arrays form, so the per-tick loops over thousands of ghosts in
+    // swarm mode stream through only the fields they use. Ghost i has type i % 4.
+    struct GhostArrays {
+        std::vector<FixVec2> position, prevPosition, startPosition, direction;
+        std::vector<uint8_t> type;   // GhostType
+        std::vector<uint8_t> state;  // GhostState
+        std::vector<int32_t> stateTicks, speed;
+
+        int Count() const { return (int)position.size(); }
+        void Clear();
+        void Add(FixVec2 start);
+    };
+
+    // Static pellet layout, one array per field like GhostArrays; whether each one is still
+    // there is IsPelletActive().
+    static constexpr int32_t PELLET_RADIUS = 2 * SUBPIXELS;
+    static constexpr int32_t POWER_PELLET_RADIUS = 6 * SUBPIXELS;
+    static constexpr int PELLET_POINTS = 10;
+    static constexpr int POWER_PELLET_POINTS = 50;
+
+    struct PelletArrays {
+        std::vector<FixVec2> position;
+        std::vector<int32_t> radius;
+        std::vector<uint8_t> isPowerPellet;
+
+        int Count() const { return (int)position.size(); }
+        int Points(int i) const { return isPowerPellet[i] ? POWER_PELLET_POINTS : PELLET_POINTS; }
+        void Clear();
+        void Reserve(size_t count);
+        void Add(FixVec2 at, bool power);
+    };
+
+    // Everything Step() changes, in one trivially copyable block, for rollback, search and
+    // rewind. Sized for classic-scale levels: SaveSnapshot() fails on levels with more than
+    // SNAPSHOT_MAX_GHOSTS ghosts or SNAPSHOT_MAX_PELLETS pellets (huge mazes, ghost swarms).
+    static constexpr int SNAPSHOT_MAX_GHOSTS = 16;
+    static constexpr int SNAPSHOT_MAX_PELLETS = 1024;
+
+    struct Snapshot {
+        Player player;
+        FixVec2 ghostPosition[SNAPSHOT_MAX_GHOSTS];
+        FixVec2 ghostPrevPosition[SNAPSHOT_MAX_GHOSTS];
+        FixVec2 ghostDirection[SNAPSHOT_MAX_GHOSTS];
+        int32_t ghostStateTicks[SNAPSHOT_MAX_GHOSTS];
+        int32_t ghostSpeed[SNAPSHOT_MAX_GHOSTS];
+        uint8_t ghostState[SNAPSHOT_MAX_GHOSTS];
+        uint64_t pelletBits[SNAPSHOT_MAX_PELLETS / 64];
+        uint64_t levelHash;          // GetLevelHash() of the level it was saved on
+        int ghostCount, pelletCount;
+        int playerLives, score, activePellets, ghostsEatenThisPowerup;
+        int32_t roundStateTicks;
+        uint8_t roundState, gameOver, victory;
+        uint64_t zobristHash;
+        uint32_t playerZobristCell, ghostZobristCell[SNAPSHOT_MAX_GHOSTS];
+    };
+
+    // Level loading. Returns false (and leaves IsLoaded() false) if there is no usable map.
+    // LoadLevel() takes a text level (compiled once through the level cache) or a .lvlc file;
+    // if the file can't be loaded, a level of the same name in embedded_levels.h is used.
+    bool LoadLevel(const char* fileName);
+    bool LoadLevelFromLines(const std::vector<std::string>& lines);
+    bool LoadLevelData(const LevelData& level);
+    bool WasLastLoadCached() const { return lastLoadCached; }
+    bool WasLastLoadEmbedded() const { return lastLoadEmbedded; }
+    uint64_t GetLevelHash() const { return levelHash; } // Walls, pellets, spawns and speeds; identifies the level in replays
+
+    // Kept across loads. Call Reset() afterwards.
+    void SetSpeeds(const Speeds& newSpeeds);
+    const Speeds& GetSpeeds() const { return speeds; }
+
+    // Stress mode: replaces the level's ghosts with 'count' ghosts on random open tiles away
+    // from the player start, or restores the level's own ghosts when count is 0. Lasts until
+    // the next load; call Reset() afterwards.
+    void SpawnGhostSwarm(int count, unsigned seed = 1);
+
+    // Snapshots belong to the level (and speeds) they were saved on; RestoreSnapshot()
+    // refuses any other GetLevelHash().
+    bool CanSnapshot() const { return ghosts.Count() <= SNAPSHOT_MAX_GHOSTS && pellets.Count() <= SNAPSHOT_MAX_PELLETS; }
+    bool SaveSnapshot(Snapshot& out) const;
+    bool RestoreSnapshot(const Snapshot& in);
+
+    // Zobrist hash of the player tile, every ghost's tile and state, and the set of uneaten
+    // pellets: equal for states that differ only within tiles, timers or score, which is what
+    // search code wants for spotting transpositions. Step() keeps it up to date by XORing keys
+    // in and out as entities change tile or state, so it costs nothing to read. Kept only for
+    // levels that CanSnapshot() (0 otherwise); ComputeZobristHash() recomputes it from scratch.
+    uint64_t GetZobristHash() const { return zobristHash; }
+    uint64_t ComputeZobristHash() const;
+    void SetZobristEnabled(bool enabled);  // Off skips the per-tick upkeep; the hash reads 0
+
+    // Starts a fresh game: every pellet back, with three lives and no score unless carried
+    // over from a previous level.
+    void Reset(int lives = 3, int startScore = 0);
+
+    // Advances the game by exactly one fixed tick.
+    PacStepResult Step(PacAction action);
+
+    // Observation
+    bool IsLoaded() const { return mapLoaded; }
+    bool IsFinished() const { return gameOver || victory; }
+    bool IsGameOver() const { return gameOver; }
+    bool IsVictory() const { return victory; }
+    int GetScore() const { return score; }
+    int GetLives() const { return playerLives; }
+    int GetActivePellets() const { return activePellets; }
+    RoundState GetRoundState() const { return roundState; }
+    int GetRoundStateTicks() const { return roundStateTicks; }
+    const Player& GetPlayer() const { return player; }
+    const GhostArrays& GetGhosts() const { return ghosts; }
+    int GetGhostCount() const { return ghosts.Count(); }
+    const PelletArrays& GetPellets() const { return pellets; }
+    bool IsPelletActive(int i) const { return (pelletBits[i >> 6] >> (i & 63)) & 1; }
+    int GetPelletAtTile(int x, int y) const { return grid.InBounds(x, y) ? pelletAtTile[grid.Index(x, y)] : -1; }
+    const TileGrid& GetGrid() const { return grid; }
+    const TileDistanceTable& GetDistanceTable() const { return distanceTable; }
+    const MazeAnalysis& GetMazeAnalysis() const { return maze; }
+
+    // Pellets the player can't reach from its start are left out of every game (they are
+    // never active and don't count towards clearing the level).
+    bool IsPelletReachable(int i) const { return (reachablePelletBits[i >> 6] >> (i & 63)) & 1; }
+    int GetUnreachablePelletCount() const { return pellets.Count() - reachablePelletCount; }
+    int GetMapWidth() const { return grid.width; }
+    int GetMapHeight() const { return grid.height; }
+
+    static Vec2 WorldToTile(Vec2 worldPos) {
+        return { std::floor(worldPos.x / TILE_SIZE), std::floor(worldPos.y / TILE_SIZE) };
+    }
+    static Vec2 WorldToTile(FixVec2 pos) { return { (float)TileCoord(pos.x), (float)TileCoord(pos.y) }; }
+
+    // Positions stay inside the map (tunnels wrap them), but this floors anything right of
+    // -TILE_UNITS anyway.
+    static int TileCoord(int32_t v) { return (v + TILE_UNITS) / TILE_UNITS - 1; }
+    static FixVec2 TileCenter(int x, int y) { return { x * TILE_UNITS + TILE_UNITS / 2, y * TILE_UNITS + TILE_UNITS / 2 }; }
+
+    // Renderer side: fixed-point to pixels.
+    static Vec2 ToWorld(FixVec2 pos) { return { pos.x * (1.0f / SUBPIXELS), pos.y * (1.0f / SUBPIXELS) }; }
+    static float ToPixels(int32_t units) { return units * (1.0f / SUBPIXELS); }
+
+    // Points for the n-th ghost eaten on one power pellet: 200, 400, 800, then 1600 for the
+    // fourth and every ghost after it.
+    static int GhostEatPoints(int eatenCount) { return 100 * (1 << std::min(eatenCount, 4)); }
+
+    //----------------------------------------------------------------------------------
+    // Per-game rules as pure functions of their arguments. Step() and PacmanBatch (which
+    // keeps its games in arrays of its own) both go through these, so the two can't drift
+    // apart; `./bench parity` checks that they still play identically. A DistanceFn is
+    // (Vec2 fromTile, Vec2 toTile) -> uint16_t tiles, as TileDistanceTable gives them.
+    //----------------------------------------------------------------------------------
+
+    // Sets the direction the player wants next; ACTION_NONE keeps the last one.
+    static void ApplyAction(PacAction action, FixVec2& desiredDirection);
+
+    // One tick of player movement: turn or stop on a tile centre, move, and wrap through
+    // tunnels. Returns true if it wrapped.
+    static bool MovePlayer(FixVec2& position, FixVec2& direction, FixVec2 desiredDirection, int32_t speed,
+                           const TileGrid& grid, const MazeAnalysis& maze);
+
+    // Classic per-ghost targeting. Targets may land in walls or off the map; the distance
+    // table snaps them to the nearest open tile.
+    template <typename DistanceFn>
+    static Vec2 GhostTargetTile(int type, int state, Vec2 ghostTile, Vec2 homeTile, Vec2 blinkyTile, Vec2 playerTile,
+                                FixVec2 playerDirection, const Vec2* scatterTiles, DistanceFn distance);
+
+    // Eyes that made it back home (or can't get there) come back to life.
+    template <typename DistanceFn>
+    static bool EyesRevive(Vec2 ghostTile, Vec2 homeTile, DistanceFn distance);
+
+    // Where a ghost on the centre of (tileX, tileY) heads next: straight on along a corridor,
+    // otherwise the exit nearest target() (only called then), reversing only at a dead end.
+    template <typename TargetFn, typename DistanceFn>
+    static FixVec2 ChooseGhostDirection(int tileX, int tileY, FixVec2 direction, const TileGrid& grid, const MazeAnalysis& maze,
+                                        TargetFn target, DistanceFn distance);
+
+private:
+    PelletArrays pellets;
+    std::vector<uint64_t> pelletBits;  // Bit i set while pellet i is uneaten
+    std::vector<uint64_t> reachablePelletBits;
+    int reachablePelletCount = 0;
+    std::vector<int> pelletAtTile;    // Grid index -> pellet index, -1 if none
+    GhostArrays ghosts;
+    std::vector<FixVec2> levelGhostStarts;
+    Player player;
+
+    // Ghosts are re-binned only when they snap to a tile centre, so a ghost can be up to a
+    // tile plus one step away from its bin; queries widen their box by that much.
+    static constexpr int32_t GHOST_HASH_SLACK = TILE_UNITS + MAX_SPEED;
+    SpatialHash ghostHash;
+    bool ghostHashActive = false;     // Only for swarms of SPATIAL_HASH_MIN_GHOSTS or more
+    std::vector<int> nearbyGhosts;
+    std::vector<uint8_t> ghostAtCenter;  // Scratch for UpdateGhosts()
+
+    TileGrid grid;                    // Wall lookup used by movement and path-finding
+    TileDistanceTable distanceTable;  // All-pairs tile distances, built once per map
+    MazeAnalysis maze;                // Tunnel exits, corridor nodes and reachability, built once per map
+    Vec2 scatterTiles[4];             // Home corner for each GhostType
+
+    int playerLives = 3;
+    int score = 0;
+    int activePellets = 0;
+    bool gameOver = false;
+    bool victory = false;
+    bool mapLoaded = false;
+    bool lastLoadCached = false;
+    bool lastLoadEmbedded = false;
+    uint64_t layoutHash = 0;
+    uint64_t levelHash = 0;
+    Speeds speeds;
+
+    // Incremental Zobrist hash. Each entity's "cell" (tile, plus state for ghosts) is cached,
+    // so a tick only pays for the keys of entities that actually changed cell.
+    bool zobristEnabled = true;
+    bool zobristActive = false;            // Enabled and the level CanSnapshot()
+    uint64_t zobristHash = 0;
+    uint32_t playerZobristCell = 0;
+    std::vector<uint32_t> ghostZobristCell;
+
+    RoundState roundState = READY;
+    int roundStateTicks = READY_TICKS;
+    int ghostsEatenThisPowerup = 0;
+
+    uint16_t TileDistance(Vec2 fromTile, Vec2 toTile);
+    Vec2 GhostTargetTile(int ghost);
+
+    void RefillPellets();
+    uint64_t ZobristKey(uint64_t kind, uint64_t value) const;
+    uint32_t PlayerZobristCell() const;
+    uint32_t GhostZobristCell(int ghost) const;
+    void RebuildZobrist();
+    void RehashPlayer();
+    void RehashGhost(int ghost);
+    void StartNewRound();
+    void UpdatePlayer();
+    void UpdateGhosts();
+    void UpdateGhost(int ghost);
+    void MoveGhost(int ghost);
+    void ResetGhosts();
+    void CollideWithGhosts(PacStepResult& result);
+    void SnapInterpolation();
+};
+
+static_assert(std::is_trivially_copyable<PacmanCore::Snapshot>::value, "Snapshots are copied with memcpy");
+
+template <typename DistanceFn>
+Vec2 PacmanCore::GhostTargetTile(int type, int state, Vec2 ghostTile, Vec2 homeTile, Vec2 blinkyTile, Vec2 playerTile,
+                                 FixVec2 playerDirection, const Vec2* scatterTiles, DistanceFn distance) {
+    if (state == EATEN) return homeTile;
+    if (state == FRIGHTENED) return scatterTiles[type];
+
+    switch (type) {
+        case BLINKY: return playerTile;
+        case PINKY: return { playerTile.x + playerDirection.x * 4, playerTile.y + playerDirection.y * 4 };
+        case INKY: {
+            Vec2 pivot = { playerTile.x + playerDirection.x * 2, playerTile.y + playerDirection.y * 2 };
+            return Vec2Add(blinkyTile, Vec2Scale(Vec2Subtract(pivot, blinkyTile), 2));
+        }
+        case CLYDE: return distance(ghostTile, playerTile) > 8 ? playerTile : scatterTiles[CLYDE];
+    }
+    return playerTile;
+}
+
+template <typename DistanceFn>
+bool PacmanCore::EyesRevive(Vec2 ghostTile, Vec2 homeTile, DistanceFn distance) {
+    bool atHome = ghostTile.x == homeTile.x && ghostTile.y == homeTile.y;
+    return atHome || distance(ghostTile, homeTile) == TileDistanceTable::UNREACHABLE;
+}
+
+template <typename TargetFn, typename DistanceFn>
+FixVec2 PacmanCore::ChooseGhostDirection(int tileX, int tileY, FixVec2 direction, const TileGrid& grid, const MazeAnalysis& maze,
+                                         TargetFn target, DistanceFn distance) {
+    // Ghosts never reverse, so on a corridor tile the only way is straight on
+    if (!maze.IsNode(tileX, tileY) && (maze.Exits(tileX, tileY) & DirectionExit(direction.x, direction.y))) return direction;
+
+    Vec2 targetTile = target();
+    uint16_t minDist = TileDistanceTable::UNREACHABLE;
+    FixVec2 bestDir = {0, 0};
+    static const FixVec2 possibleDirs[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    FixVec2 oppositeDir = FixScale(direction, -1);
+
+    // Table lookup per neighbour; no per-ghost search
+    uint8_t exits = grid.Exits(tileX, tileY);
+    for (int d = 0; d < 4; d++) {
+        const FixVec2& dir = possibleDirs[d];
+        if (FixEquals(dir, oppositeDir) || !(exits & (1 << d))) continue;
+        uint16_t dist = distance({ (float)(tileX + dir.x), (float)(tileY + dir.y) }, targetTile);
+        if (bestDir.x == 0 && bestDir.y == 0) bestDir = dir; // Fallback if nothing is reachable
+        if (dist < minDist) {
+            minDist = dist;
+            bestDir = dir;
+        }
+    }
+    if (bestDir.x != 0 || bestDir.y != 0) return bestDir;
+    if (!grid.IsWall(tileX + oppositeDir.x, tileY + oppositeDir.y)) return oppositeDir; // Dead end
+    return direction;
+}
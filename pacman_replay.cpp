@@ -0,0 +1,258 @@
+/*******************************************************************************************
+*
+* pacman_replay.cpp - Deterministic input recording and seekable replay (see pacman_replay.h)
+*
+********************************************************************************************/
+#include "pacman_replay.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+static constexpr char REPLAY_MAGIC[4] = { 'N', 'S', 'R', 'P' };
+static constexpr uint32_t REPLAY_VERSION = 2; // 2: fixed-point positions
+
+struct ReplayFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t snapshotSize;     // sizeof(PacmanCore::Snapshot) of the writing build
+    uint32_t keyframeInterval;
+    uint64_t levelHash;
+    uint64_t inputBytes;
+    int32_t tickCount;
+    uint32_t keyframeCount;
+};
+
+//----------------------------------------------------------------------------------
+// Encoding
+//----------------------------------------------------------------------------------
+
+static void WriteVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static size_t ReadVarint(const std::vector<uint8_t>& in, size_t offset, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; offset < in.size() && shift < 35; shift += 7) {
+        uint8_t byte = in[offset++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return offset;
+}
+
+void PacmanRecording::CloseRun() {
+    if (openLength == 0) return;
+    inputs.push_back((uint8_t)openAction);
+    WriteVarint(inputs, (uint32_t)openLength);
+    openLength = 0;
+}
+
+// Loads the run at 'offset' into the cursor (runStart is left to the caller). The run still
+// being recorded sits just past the closed ones.
+bool PacmanRecording::ReadRun(size_t offset, Cursor& cursor) const {
+    cursor.runOffset = offset;
+    if (offset < inputs.size()) {
+        uint32_t length;
+        cursor.action = (PacAction)inputs[offset];
+        cursor.nextOffset = ReadVarint(inputs, offset + 1, length);
+        cursor.runLength = (int)length;
+        return true;
+    }
+    if (offset == inputs.size() && openLength > 0) {
+        cursor.action = openAction;
+        cursor.nextOffset = offset;
+        cursor.runLength = openLength;
+        return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Recording
+//----------------------------------------------------------------------------------
+
+bool PacmanRecording::Begin(const PacmanCore& game) {
+    inputs.clear();
+    keyframes.clear();
+    openAction = ACTION_NONE;
+    openStart = openLength = 0;
+    tickCount = 0;
+    levelHash = game.GetLevelHash();
+    recording = game.IsLoaded() && game.CanSnapshot();
+    return recording;
+}
+
+void PacmanRecording::Record(const PacmanCore& game, PacAction action) {
+    if (!recording) return;
+
+    if (openLength > 0 && action != openAction) CloseRun();
+    if (openLength == 0) {
+        openAction = action;
+        openStart = tickCount;
+    }
+    openLength++;
+
+    if (tickCount % KEYFRAME_INTERVAL == 0) {
+        Keyframe frame{};  // Zeroed, so padding never leaks into the state hash
+        frame.tick = tickCount;
+        frame.runOffset = inputs.size();
+        frame.runStart = openStart;
+        game.SaveSnapshot(frame.state);
+        keyframes.push_back(frame);
+    }
+    tickCount++;
+}
+
+void PacmanRecording::TruncateTo(int tick) {
+    if (keyframes.empty() || tick >= tickCount) return;
+    if (tick < 0) tick = 0;
+
+    CloseRun();
+    while (!keyframes.empty() && keyframes.back().tick >= tick) keyframes.pop_back();
+    tickCount = tick;
+    if (tick == 0) {
+        inputs.clear();
+        return;
+    }
+
+    // Find the run holding the last kept tick, cut the stream there and reopen that run
+    size_t offset = keyframes.back().runOffset;
+    int start = keyframes.back().runStart;
+    Cursor run;
+    while (ReadRun(offset, run)) {
+        if (start + run.runLength >= tick) {
+            inputs.resize(offset);
+            openAction = run.action;
+            openStart = start;
+            openLength = tick - start;
+            return;
+        }
+        offset = run.nextOffset;
+        start += run.runLength;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Playback
+//----------------------------------------------------------------------------------
+
+bool PacmanRecording::Seek(PacmanCore& game, int tick, Cursor& cursor) const {
+    if (keyframes.empty() || game.GetLevelHash() != levelHash) return false;
+    tick = std::clamp(tick, 0, tickCount);
+
+    const Keyframe& frame = keyframes[std::min<size_t>(tick / KEYFRAME_INTERVAL, keyframes.size() - 1)];
+    if (!game.RestoreSnapshot(frame.state)) return false;
+
+    cursor = Cursor();
+    cursor.tick = frame.tick;
+    cursor.runStart = frame.runStart;
+    if (!ReadRun(frame.runOffset, cursor)) return false;
+
+    while (cursor.tick < tick) game.Step(Next(cursor));
+    return true;
+}
+
+PacAction PacmanRecording::Next(Cursor& cursor) const {
+    if (cursor.tick >= tickCount) return ACTION_NONE;
+    while (cursor.tick >= cursor.runStart + cursor.runLength) {
+        int start = cursor.runStart + cursor.runLength;
+        if (!ReadRun(cursor.nextOffset, cursor)) return ACTION_NONE;
+        cursor.runStart = start;
+    }
+    cursor.tick++;
+    return cursor.action;
+}
+
+uint64_t PacmanRecording::StateHash(const PacmanCore& game) {
+    PacmanCore::Snapshot state{};
+    game.SaveSnapshot(state);
+    return HashBytes(&state, sizeof(state));
+}
+
+uint64_t PacmanRecording::GetKeyframeHash(int index) const {
+    return HashBytes(&keyframes[index].state, sizeof(PacmanCore::Snapshot));
+}
+
+//----------------------------------------------------------------------------------
+// Files
+//----------------------------------------------------------------------------------
+
+bool PacmanRecording::Save(const char* fileName) const {
+    std::vector<uint8_t> stream = inputs;
+    if (openLength > 0) {
+        stream.push_back((uint8_t)openAction);
+        WriteVarint(stream, (uint32_t)openLength);
+    }
+
+    ReplayFileHeader header;
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.snapshotSize = sizeof(PacmanCore::Snapshot);
+    header.keyframeInterval = KEYFRAME_INTERVAL;
+    header.levelHash = levelHash;
+    header.inputBytes = stream.size();
+    header.tickCount = tickCount;
+    header.keyframeCount = (uint32_t)keyframes.size();
+
+    FILE* file = fopen(fileName, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !stream.empty()) ok = fwrite(stream.data(), stream.size(), 1, file) == 1;
+    for (const auto& frame : keyframes) {
+        if (!ok) break;
+        int32_t tick = frame.tick, runStart = frame.runStart;
+        uint64_t runOffset = frame.runOffset;
+        ok = fwrite(&tick, sizeof(tick), 1, file) == 1 && fwrite(&runStart, sizeof(runStart), 1, file) == 1 &&
+             fwrite(&runOffset, sizeof(runOffset), 1, file) == 1 && fwrite(&frame.state, sizeof(frame.state), 1, file) == 1;
+    }
+    return (fclose(file) == 0) && ok;
+}
+
+bool PacmanRecording::Load(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (!file) return false;
+
+    ReplayFileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) == 0 &&
+              header.version == REPLAY_VERSION &&
+              header.snapshotSize == sizeof(PacmanCore::Snapshot) &&
+              header.keyframeInterval == KEYFRAME_INTERVAL &&
+              header.tickCount >= 0 && header.inputBytes <= (uint64_t)header.tickCount * 6;
+
+    std::vector<uint8_t> stream;
+    std::vector<Keyframe> frames;
+    if (ok) {
+        stream.resize((size_t)header.inputBytes);
+        ok = stream.empty() || fread(stream.data(), stream.size(), 1, file) == 1;
+    }
+    for (uint32_t i = 0; ok && i < header.keyframeCount; i++) {
+        Keyframe frame{};
+        int32_t tick, runStart;
+        uint64_t runOffset;
+        ok = fread(&tick, sizeof(tick), 1, file) == 1 && fread(&runStart, sizeof(runStart), 1, file) == 1 &&
+             fread(&runOffset, sizeof(runOffset), 1, file) == 1 && fread(&frame.state, sizeof(frame.state), 1, file) == 1 &&
+             runOffset <= stream.size();
+        // Seek() finds keyframe i at tick i * KEYFRAME_INTERVAL, inside the recording
+        ok = ok && tick == (int64_t)i * KEYFRAME_INTERVAL && tick <= header.tickCount && runStart >= 0 && runStart <= tick;
+        frame.tick = tick;
+        frame.runStart = runStart;
+        frame.runOffset = (size_t)runOffset;
+        frames.push_back(frame);
+    }
+    fclose(file);
+    if (!ok) return false;
+
+    inputs = std::move(stream);
+    keyframes = std::move(frames);
+    openAction = ACTION_NONE;
+    openStart = openLength = 0;
+    tickCount = header.tickCount;
+    levelHash = header.levelHash;
+    recording = false;
+    return true;
+}
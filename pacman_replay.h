@@ -0,0 +1,97 @@
+/*******************************************************************************************
+*
+* pacman_replay.h - Deterministic input recording and seekable replay for PacmanCore
+*
+* PacmanCore is deterministic: the same starting state and the same action every tick give
+* a bit-identical game. A recording therefore only needs the inputs, plus a state keyframe
+* every KEYFRAME_INTERVAL ticks so playback can start anywhere without replaying the whole
+* session:
+*
+*     inputs      runs of (action byte, LEB128 tick count); held keys cost 2-3 bytes per run
+*     keyframes   { tick, input position, PacmanCore::Snapshot } every KEYFRAME_INTERVAL ticks
+*
+*     recording.Begin(game);              // right after game.Reset()
+*     recording.Record(game, action);     // before every game.Step(action)
+*     ...
+*     recording.Seek(game, tick, cursor); // nearest keyframe, then fast-forward headlessly
+*     game.Step(recording.Next(cursor));  // continue playing back from there
+*
+* Keyframes use snapshots, so levels where CanSnapshot() is false (ghost swarms, huge mazes)
+* are not recorded. Saved files store raw snapshots and are only valid for a build with the
+* same Snapshot layout, which the header checks.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pacman_core.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class PacmanRecording {
+public:
+    static constexpr int KEYFRAME_INTERVAL = 300; // 5 seconds of game time
+
+    // Read position in the input stream. Kept by playback code between ticks.
+    struct Cursor {
+        int tick = 0;           // Tick whose action Next() returns
+        size_t runOffset = 0;   // Byte offset of the run containing 'tick'
+        size_t nextOffset = 0;  // Byte offset just past that run
+        int runStart = 0;       // First tick of that run
+        int runLength = 0;
+        PacAction action = ACTION_NONE;
+    };
+
+    // Starts a new recording from the current state (call right after Reset()). Returns
+    // false, and records nothing, if the level can't be snapshotted.
+    bool Begin(const PacmanCore& game);
+    bool IsRecording() const { return recording; }
+
+    // Appends the action about to be stepped, saving a keyframe when one is due.
+    void Record(const PacmanCore& game, PacAction action);
+
+    // Drops every tick from 'tick' on, e.g. after rewinding. Recording continues from there.
+    void TruncateTo(int tick);
+
+    // Stops recording. Playback works either way.
+    void Finish() { recording = false; }
+
+    // Puts 'game' into its state just before 'tick' was stepped (clamped to the recorded
+    // range) and points 'cursor' at that tick. Fails if 'game' holds a different level.
+    bool Seek(PacmanCore& game, int tick, Cursor& cursor) const;
+
+    // Action for cursor.tick, then advances the cursor. ACTION_NONE past the end.
+    PacAction Next(Cursor& cursor) const;
+
+    bool Save(const char* fileName) const;
+    bool Load(const char* fileName);
+
+    int GetTickCount() const { return tickCount; }
+    int GetKeyframeCount() const { return (int)keyframes.size(); }
+    size_t GetInputBytes() const { return inputs.size(); }
+    uint64_t GetLevelHash() const { return levelHash; }
+
+    // Hash of the full game state, for checking that playback matches the original.
+    static uint64_t StateHash(const PacmanCore& game);
+    uint64_t GetKeyframeHash(int index) const;
+    int GetKeyframeTick(int index) const { return keyframes[index].tick; }
+
+private:
+    struct Keyframe {
+        int tick;
+        size_t runOffset;  // Where the run containing 'tick' starts in 'inputs'
+        int runStart;
+        PacmanCore::Snapshot state;
+    };
+
+    std::vector<uint8_t> inputs;      // Closed runs
+    PacAction openAction = ACTION_NONE; // The run still being recorded
+    int openStart = 0, openLength = 0;
+    std::vector<Keyframe> keyframes;
+    int tickCount = 0;
+    uint64_t levelHash = 0;
+    bool recording = false;
+
+    void CloseRun();
+    bool ReadRun(size_t offset, Cursor& cursor) const;
+};
@@ -0,0 +1,92 @@
+/*******************************************************************************************
+*
+* pong_ai.h - Pong paddle AI that predicts where the ball will arrive
+*
+* The old AI moved towards the ball's current height every frame. PongAi instead works out
+* where the ball will cross its paddle with PredictPongCrossing(), walls included, and heads
+* there. Wall bounces don't change that answer, so the prediction only runs when the ball's
+* path really changes, on a serve or a paddle hit; every other tick just moves the paddle:
+*
+*     ai.Reset(PONG_AI_LEVELS[PONG_AI_NORMAL], seed);
+*     if (events & (PONG_HIT_LEFT | PONG_HIT_RIGHT)) ai.OnBallChanged(ball, faceX, fieldHeight);
+*     paddle.y = ai.Step(ball, paddle.y, paddle.height, fieldHeight, TICK_DT);   // every tick
+*
+* Two knobs make it beatable: a reaction delay before it acts on a new prediction, and a
+* random aim error drawn once per prediction. The "Chase" level is the old behaviour.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pong_physics.h"
+#include <random>
+#include <cmath>
+
+struct PongAiSettings {
+    const char* name;
+    bool predict;          // false = chase the ball's current height, as the original AI did
+    float paddleSpeed;     // Pixels per second
+    float reactionDelay;   // Seconds before it starts moving to a new prediction
+    float aimError;        // Largest aim offset in pixels, uniform either way
+};
+
+enum PongAiLevel { PONG_AI_CHASE, PONG_AI_EASY, PONG_AI_NORMAL, PONG_AI_HARD, PONG_AI_LEVEL_COUNT };
+
+inline constexpr PongAiSettings PONG_AI_LEVELS[PONG_AI_LEVEL_COUNT] = {
+    { "Chase",  false, 350.0f, 0.0f,  0.0f },
+    { "Easy",   true,  300.0f, 0.30f, 60.0f },
+    { "Normal", true,  350.0f, 0.15f, 30.0f },
+    { "Hard",   true,  450.0f, 0.05f, 8.0f },
+};
+
+class PongAi {
+public:
+    void Reset(const PongAiSettings& newSettings, unsigned seed) {
+        settings = newSettings;
+        rng.seed(seed);
+        hasAim = hasPendingAim = false;
+        delayLeft = 0.0f;
+    }
+
+    const PongAiSettings& GetSettings() const { return settings; }
+
+    // Re-predicts after a serve or a paddle hit. 'faceX' is where the ball's centre touches
+    // the paddle's face. A ball heading away sends the paddle back to the middle.
+    void OnBallChanged(const PongBall& ball, float faceX, float fieldHeight) {
+        if (!settings.predict) return;
+        float crossingY, crossingTime;
+        if (!PredictPongCrossing(ball, faceX, fieldHeight, crossingY, crossingTime)) crossingY = fieldHeight / 2;
+        std::uniform_real_distribution<float> error(-settings.aimError, settings.aimError);
+        pendingAimY = crossingY + (settings.aimError > 0.0f ? error(rng) : 0.0f);
+        hasPendingAim = true;
+        delayLeft = settings.reactionDelay;
+    }
+
+    // Returns the paddle's new top edge after 'deltaTime' seconds.
+    float Step(const PongBall& ball, float paddleY, float paddleHeight, float fieldHeight, float deltaTime) {
+        float targetY;
+        if (!settings.predict) {
+            targetY = ball.position.y;
+        } else {
+            if (hasPendingAim && (delayLeft -= deltaTime) <= 0.0f) {
+                aimY = pendingAimY;
+                hasAim = true;
+                hasPendingAim = false;
+            }
+            if (!hasAim) return paddleY;
+            targetY = aimY;
+        }
+
+        // Straight to the target without overshooting, so the paddle doesn't jitter around it
+        float offset = targetY - (paddleY + paddleHeight / 2);
+        float step = settings.paddleSpeed * deltaTime;
+        paddleY += std::fmax(-step, std::fmin(step, offset));
+        return std::fmax(0.0f, std::fmin(fieldHeight - paddleHeight, paddleY));
+    }
+
+private:
+    PongAiSettings settings = PONG_AI_LEVELS[PONG_AI_NORMAL];
+    std::mt19937 rng;
+    float aimY = 0.0f, pendingAimY = 0.0f;
+    float delayLeft = 0.0f;
+    bool hasAim = false, hasPendingAim = false;
+};
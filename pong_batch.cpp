@@ -0,0 +1,68 @@
+/*******************************************************************************************
+*
+* pong_batch.cpp - Seeded Pong rallies played in bulk (see pong_batch.h)
+*
+********************************************************************************************/
+#include "pong_batch.h"
+#include <mutex>
+
+// splitmix64, so neighbouring rally indices get unrelated seeds
+static uint64_t RallySeed(uint64_t seed, uint64_t rally) {
+    uint64_t z = seed + rally * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int PongBatch::PlayRally(const PongAiSettings& candidate, const PongAiSettings& opponent, uint64_t rallySeed,
+                         int& hits, bool& finished) {
+    PongCore game;
+    game.Reset((unsigned)rallySeed);
+    game.SetAi(PongCore::LEFT, &opponent);
+    game.SetAi(PongCore::RIGHT, &candidate);
+    game.Serve((rallySeed >> 32) & 1 ? PongCore::LEFT : PongCore::RIGHT);
+
+    hits = 0;
+    finished = false;
+    for (int tick = 0; tick < MAX_RALLY_TICKS; tick++) {
+        PongStepResult result = game.Step(PONG_ACTION_NONE);
+        if (result.events & PONG_EVENT_PADDLE) hits++;
+        if (result.scorer >= 0) {
+            finished = true;
+            return result.scorer;
+        }
+    }
+    return -1;
+}
+
+std::vector<PongRallyStats> PongBatch::PlayRallies(const std::vector<PongAiSettings>& candidates, const PongAiSettings& opponent,
+                                                   int rallies, uint64_t seed) {
+    int candidateCount = (int)candidates.size();
+    std::vector<PongRallyStats> stats(candidateCount);
+    if (candidateCount == 0 || rallies <= 0 || rallies > MaxRallies(candidates.size())) return stats;
+
+    // One work item per (candidate, rally); each chunk counts locally and merges once
+    std::mutex mergeMutex;
+    pool->ParallelFor(candidateCount * rallies, [&](int begin, int end) {
+        std::vector<PongRallyStats> local(candidateCount);
+        for (int item = begin; item < end; item++) {
+            int candidate = item / rallies, rally = item % rallies;
+            int hits;
+            bool finished;
+            int winner = PlayRally(candidates[candidate], opponent, RallySeed(seed, rally), hits, finished);
+            PongRallyStats& s = local[candidate];
+            s.rallies++;
+            s.hits += hits;
+            if (winner == PongCore::RIGHT) s.wins++;
+            if (!finished) s.unfinished++;
+        }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (int c = 0; c < candidateCount; c++) {
+            stats[c].rallies += local[c].rallies;
+            stats[c].wins += local[c].wins;
+            stats[c].unfinished += local[c].unfinished;
+            stats[c].hits += local[c].hits;
+        }
+    }, 64);
+    return stats;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************************
+*
+* pong_batch.h - Seeded Pong rallies played in bulk, for tuning the AI offline
+*
+* Plays PongCore rallies AI against AI across a thread pool and counts who wins them. Each
+* candidate parameter set plays the right paddle against the same opponent on the left:
+*
+*     PongBatch batch;
+*     std::vector<PongRallyStats> stats = batch.PlayRallies(candidates, PONG_AI_LEVELS[PONG_AI_CHASE], 1000000, 7);
+*     // stats[i].WinRate(), stats[i].AverageHits() ...
+*
+* Rally i is seeded from (seed, i) alone, so the results don't depend on the thread count,
+* and every candidate faces the same serves and opponent errors, which makes the difference
+* between two candidates far less noisy than their win rates on their own.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pong_core.h"
+#include "thread_pool.h"
+#include <vector>
+#include <memory>
+#include <climits>
+
+struct PongRallyStats {
+    long long rallies = 0;
+    long long wins = 0;        // Won by the candidate
+    long long unfinished = 0;  // Still going after PongBatch::MAX_RALLY_TICKS
+    long long hits = 0;        // Paddle hits over all rallies
+
+    double WinRate() const { return rallies > 0 ? (double)wins / rallies : 0.0; }
+    double AverageHits() const { return rallies > 0 ? (double)hits / rallies : 0.0; }
+};
+
+class PongBatch {
+public:
+    static constexpr int MAX_RALLY_TICKS = 60 * (int)PongCore::TICK_RATE; // A minute of play
+
+    // threadCount 0 uses every hardware thread.
+    explicit PongBatch(int threadCount = 0) : pool(std::make_unique<ThreadPool>(threadCount)) {}
+
+    // Plays 'rallies' rallies for each candidate, each served to a random side. Returns
+    // all-zero stats if rallies is above MaxRallies(candidates.size()).
+    std::vector<PongRallyStats> PlayRallies(const std::vector<PongAiSettings>& candidates, const PongAiSettings& opponent,
+                                            int rallies, uint64_t seed);
+
+    // Largest rally count per candidate whose work items still fit the pool's int range.
+    static int MaxRallies(size_t candidateCount) {
+        return candidateCount > 0 ? (int)(INT_MAX / candidateCount) : INT_MAX;
+    }
+
+    // Plays one rally from a fresh core; returns the winning side. Safe on any thread.
+    static int PlayRally(const PongAiSettings& candidate, const PongAiSettings& opponent, uint64_t rallySeed,
+                         int& hits, bool& finished);
+
+    int GetThreadCount() const { return pool->GetThreadCount(); }
+
+private:
+    std::unique_ptr<ThreadPool> pool;
+};
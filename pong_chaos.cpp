@@ -0,0 +1,237 @@
+/*******************************************************************************************
+*
+* pong_chaos.cpp - Pong with hundreds to thousands of balls at once (see pong_chaos.h)
+*
+********************************************************************************************/
+#include "pong_chaos.h"
+#include <cstring>
+#include <cmath>
+
+//----------------------------------------------------------------------------------
+// Lanes
+//----------------------------------------------------------------------------------
+// GCC and Clang (desktop MinGW and Emscripten) vector extensions: four floats per register,
+// SSE on x86 and SIMD128 on the web with -msimd128 (scalar code otherwise, but still right).
+// Other compilers get one ball per "lane" through the same code.
+#if defined(__GNUC__)
+typedef float FloatLanes __attribute__((vector_size(16)));
+typedef int32_t MaskLanes __attribute__((vector_size(16)));
+static_assert(sizeof(FloatLanes) == PongChaos::LANES * sizeof(float), "LANES must match the vector width");
+
+static inline FloatLanes Splat(float v) { return FloatLanes{ v, v, v, v }; }
+static inline FloatLanes LaneIndices() { return FloatLanes{ 0.0f, 1.0f, 2.0f, 3.0f }; }
+static inline MaskLanes Less(FloatLanes a, FloatLanes b) { return a < b; }
+static inline bool AnyLane(MaskLanes m) { return (m[0] | m[1] | m[2] | m[3]) != 0; }
+static inline FloatLanes Select(MaskLanes m, FloatLanes a, FloatLanes b) {
+    return (FloatLanes)(((MaskLanes)a & m) | ((MaskLanes)b & ~m));
+}
+#else
+typedef float FloatLanes;
+typedef int32_t MaskLanes;
+
+static inline FloatLanes Splat(float v) { return v; }
+static inline FloatLanes LaneIndices() { return 0.0f; }
+static inline MaskLanes Less(FloatLanes a, FloatLanes b) { return a < b ? -1 : 0; }
+static inline bool AnyLane(MaskLanes m) { return m != 0; }
+static inline FloatLanes Select(MaskLanes m, FloatLanes a, FloatLanes b) { return m ? a : b; }
+#endif
+
+static constexpr int LANE_WIDTH = (int)(sizeof(FloatLanes) / sizeof(float));
+
+static inline FloatLanes LoadLanes(const float* p) { FloatLanes v; memcpy(&v, p, sizeof(v)); return v; }
+static inline void StoreLanes(float* p, FloatLanes v) { memcpy(p, &v, sizeof(v)); }
+static inline FloatLanes Abs(FloatLanes v) { return Select(Less(v, Splat(0.0f)), -v, v); }
+static inline FloatLanes Clamp(FloatLanes v, FloatLanes low, FloatLanes high) {
+    v = Select(Less(v, low), low, v);
+    return Select(Less(high, v), high, v);
+}
+
+//----------------------------------------------------------------------------------
+// Setup
+//----------------------------------------------------------------------------------
+
+PongChaos::PongChaos(float width, float height) : fieldWidth(width), fieldHeight(height) {
+    Reset(0, 1);
+}
+
+void PongChaos::Reset(int count, unsigned seed) {
+    rng.seed(seed);
+    ballCount = count;
+    scores[PongCore::LEFT] = scores[PongCore::RIGHT] = 0;
+    lastContacts = 0;
+    aiBall = -1;
+
+    float paddleY = fieldHeight / 2 - PongCore::PADDLE_HEIGHT / 2;
+    paddles[PongCore::LEFT] = { PongCore::PADDLE_MARGIN, paddleY, PongCore::PADDLE_WIDTH, PongCore::PADDLE_HEIGHT };
+    paddles[PongCore::RIGHT] = { fieldWidth - PongCore::PADDLE_MARGIN - PongCore::PADDLE_WIDTH, paddleY,
+                                 PongCore::PADDLE_WIDTH, PongCore::PADDLE_HEIGHT };
+
+    size_t padded = (size_t)(count + LANES - 1) / LANES * LANES;
+    x.assign(padded, fieldWidth / 2);
+    y.assign(padded, fieldHeight / 2);
+    vx.assign(padded, 0.0f);
+    vy.assign(padded, 0.0f);
+
+    // Spread over the middle half of the field so they don't all start on top of each other
+    std::uniform_real_distribution<float> spreadX(fieldWidth / 4, fieldWidth * 3 / 4);
+    for (int i = 0; i < count; i++) {
+        Serve(i);
+        x[i] = spreadX(rng);
+    }
+    prevX = x;
+    prevY = y;
+    // Two balls across, so a contact query (+-diameter around a ball) is one cell wide: it
+    // spans 2x2 cells, or up to 3x3 when rounding puts a box edge on a cell boundary
+    hash.Reset(count, 4.0f * BALL_RADIUS);
+}
+
+// From a random height on the centre line, towards a random side
+void PongChaos::Serve(int ball) {
+    std::uniform_real_distribution<float> height(BALL_RADIUS, fieldHeight - BALL_RADIUS);
+    std::uniform_real_distribution<float> speed(MIN_SPEED, MAX_SPEED), slope(-0.5f, 0.5f);
+    x[ball] = fieldWidth / 2;
+    y[ball] = height(rng);
+    vx[ball] = speed(rng) * ((rng() & 1) ? -1.0f : 1.0f);
+    vy[ball] = std::fabs(vx[ball]) * slope(rng);
+}
+
+//----------------------------------------------------------------------------------
+// Step
+//----------------------------------------------------------------------------------
+
+void PongChaos::Step(PongAction leftAction) {
+    MovePaddles(leftAction);
+    MoveBalls();
+    if (ballCollisions) CollideBalls();
+    else lastContacts = 0;
+}
+
+void PongChaos::MovePaddles(PongAction leftAction) {
+    PongBox& left = paddles[PongCore::LEFT];
+    if (leftAction == PONG_ACTION_UP && left.y > 0) left.y -= PongCore::PLAYER_SPEED * TICK_DT;
+    if (leftAction == PONG_ACTION_DOWN && left.y < fieldHeight - left.height) left.y += PongCore::PLAYER_SPEED * TICK_DT;
+
+    // The AI goes for the ball that will reach its face first (found by the last
+    // MoveBalls()), wherever the walls send it
+    PongBox& right = paddles[PongCore::RIGHT];
+    float targetY = fieldHeight / 2, crossingTime;
+    if (aiBall >= 0 && aiBall < ballCount) {
+        PongBall ball = { { x[aiBall], y[aiBall] }, { vx[aiBall], vy[aiBall] }, BALL_RADIUS };
+        PredictPongCrossing(ball, right.x - BALL_RADIUS, fieldHeight, targetY, crossingTime);
+    }
+    float offset = targetY - (right.y + right.height / 2), step = AI_SPEED * TICK_DT;
+    right.y += std::fmax(-step, std::fmin(step, offset));
+    right.y = std::fmax(0.0f, std::fmin(fieldHeight - right.height, right.y));
+}
+
+// Every ball, LANES at a time and branch-free: move, bounce off the walls and paddles, find
+// the ones that got past a paddle (handled one by one, they are rare), and keep a running
+// minimum of the time each incoming ball needs to reach the AI's face.
+void PongChaos::MoveBalls() {
+    const FloatLanes zero = Splat(0.0f), dt = Splat(TICK_DT), maxSpeed = Splat(MAX_SPEED);
+    const FloatLanes radius = Splat(BALL_RADIUS), radiusSqr = Splat(BALL_RADIUS * BALL_RADIUS);
+    const FloatLanes bottomY = Splat(fieldHeight - BALL_RADIUS);
+    const FloatLanes leftGoal = Splat(-BALL_RADIUS), rightGoal = Splat(fieldWidth + BALL_RADIUS);
+    const FloatLanes aiFaceX = Splat(paddles[PongCore::RIGHT].x - BALL_RADIUS);
+    FloatLanes firstTime = Splat(INFINITY), firstBall = Splat(-1.0f); // Ball indices as floats, exact below 2^24
+
+    struct PaddleLanes { FloatLanes left, top, right, bottom, centerY, inverseHalfHeight; } paddleLanes[2];
+    for (int side = 0; side < 2; side++) {
+        const PongBox& p = paddles[side];
+        paddleLanes[side] = { Splat(p.x), Splat(p.y), Splat(p.x + p.width), Splat(p.y + p.height),
+                              Splat(p.y + p.height / 2), Splat(2.0f / p.height) };
+    }
+
+    int count = (int)x.size();
+    for (int i = 0; i < count; i += LANE_WIDTH) {
+        FloatLanes px = LoadLanes(&x[i]), py = LoadLanes(&y[i]), pvx = LoadLanes(&vx[i]), pvy = LoadLanes(&vy[i]);
+        StoreLanes(&prevX[i], px);
+        StoreLanes(&prevY[i], py);
+        px += pvx * dt;
+        py += pvy * dt;
+
+        // Walls: mirror back inside, heading away
+        MaskLanes top = Less(py, radius);
+        py = Select(top, radius + radius - py, py);
+        pvy = Select(top, Abs(pvy), pvy);
+        MaskLanes bottom = Less(bottomY, py);
+        py = Select(bottom, bottomY + bottomY - py, py);
+        pvy = Select(bottom, -Abs(pvy), pvy);
+
+        // Paddles: Pong's bounce rule for a ball overlapping one while heading for its goal
+        for (int side = 0; side < 2; side++) {
+            const PaddleLanes& p = paddleLanes[side];
+            FloatLanes dx = px - Clamp(px, p.left, p.right), dy = py - Clamp(py, p.top, p.bottom);
+            MaskLanes heading = side == PongCore::LEFT ? Less(pvx, zero) : Less(zero, pvx);
+            MaskLanes hit = Less(dx * dx + dy * dy, radiusSqr) & heading;
+            FloatLanes speedX = Abs(pvx);
+            pvx = Select(hit, side == PongCore::LEFT ? speedX : -speedX, pvx);
+            pvy = Select(hit, (py - p.centerY) * p.inverseHalfHeight * speedX, pvy);
+        }
+        pvx = Clamp(pvx, -maxSpeed, maxSpeed); // Ball-to-ball bounces and the paddle rule can exceed it
+        pvy = Clamp(pvy, -maxSpeed, maxSpeed);
+
+        StoreLanes(&x[i], px);
+        StoreLanes(&y[i], py);
+        StoreLanes(&vx[i], pvx);
+        StoreLanes(&vy[i], pvy);
+
+        MaskLanes incoming = Less(zero, pvx) & Less(px, aiFaceX);
+        FloatLanes time = Select(incoming, (aiFaceX - px) / pvx, Splat(INFINITY));
+        MaskLanes sooner = Less(time, firstTime);
+        firstTime = Select(sooner, time, firstTime);
+        firstBall = Select(sooner, Splat((float)i) + LaneIndices(), firstBall);
+
+        MaskLanes out = Less(px, leftGoal) | Less(rightGoal, px);
+        if (!AnyLane(out)) continue;
+        for (int ball = i; ball < i + LANE_WIDTH && ball < ballCount; ball++) {
+            if (x[ball] >= -BALL_RADIUS && x[ball] <= fieldWidth + BALL_RADIUS) continue;
+            scores[x[ball] < 0.0f ? PongCore::RIGHT : PongCore::LEFT]++;
+            Serve(ball);
+            prevX[ball] = x[ball];
+            prevY[ball] = y[ball];
+        }
+    }
+
+    float bestTime = INFINITY;
+    aiBall = -1;
+    for (int lane = 0; lane < LANE_WIDTH; lane++) {
+        float laneTime, laneBall;
+        memcpy(&laneTime, (const float*)&firstTime + lane, sizeof(float));
+        memcpy(&laneBall, (const float*)&firstBall + lane, sizeof(float));
+        if (laneTime < bestTime) {
+            bestTime = laneTime;
+            aiBall = (int)laneBall;
+        }
+    }
+}
+
+// Equal-mass elastic bounces between overlapping balls that are closing on each other,
+// with the pair pushed apart so they can't stay stuck. Each pair is handled once (j > i).
+void PongChaos::CollideBalls() {
+    const float diameter = 2.0f * BALL_RADIUS, diameterSqr = diameter * diameter;
+    for (int i = 0; i < ballCount; i++) hash.Update(i, x[i], y[i]);
+
+    int contacts = 0;
+    for (int i = 0; i < ballCount; i++) {
+        hash.Query(x[i] - diameter, y[i] - diameter, x[i] + diameter, y[i] + diameter, [&](int j) {
+            if (j <= i) return;
+            float dx = x[j] - x[i], dy = y[j] - y[i], distanceSqr = dx * dx + dy * dy;
+            if (distanceSqr >= diameterSqr || distanceSqr == 0.0f) return;
+
+            float distance = std::sqrt(distanceSqr), nx = dx / distance, ny = dy / distance;
+            float closing = (vx[j] - vx[i]) * nx + (vy[j] - vy[i]) * ny;
+            if (closing < 0.0f) { // Swap the velocity components along the contact normal
+                vx[i] += closing * nx; vy[i] += closing * ny;
+                vx[j] -= closing * nx; vy[j] -= closing * ny;
+                contacts++;
+            }
+            float push = (diameter - distance) * 0.5f;
+            x[i] -= nx * push; y[i] -= ny * push;
+            x[j] += nx * push; y[j] += ny * push;
+            y[i] = std::fmax(BALL_RADIUS, std::fmin(fieldHeight - BALL_RADIUS, y[i])); // A crowd mustn't push one through a wall
+            y[j] = std::fmax(BALL_RADIUS, std::fmin(fieldHeight - BALL_RADIUS, y[j]));
+        });
+    }
+    lastContacts = contacts;
+}
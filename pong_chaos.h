@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+* pong_chaos.h - Pong with hundreds to thousands of balls at once
+*
+* The same field and paddles as PongCore (the left paddle takes actions, the right one
+* heads for whichever ball reaches it first), but every ball bounces off the walls and
+* paddles, and optionally off each other. A ball that gets past a paddle scores and is
+* served again from the middle.
+*
+* Ball state is structure-of-arrays, padded to a multiple of LANES, and the per-tick pass
+* (move, walls, paddles, out of the field) runs LANES balls at a time in SIMD registers.
+* Speeds are capped so a ball moves less than a paddle's width per tick, which keeps plain
+* overlap tests exact here; swept collision (pong_physics.h) isn't needed. Ball-to-ball
+* contacts go through a SpatialHash broadphase with cells two balls across:
+*
+*     PongChaos chaos;
+*     chaos.Reset(4096, seed);
+*     chaos.Step(PONG_ACTION_NONE);      // chaos.x[i], chaos.y[i] for i < GetBallCount()
+*
+* Raylib-free like PongCore; `./bench chaos` times Step() against the ball count.
+*
+********************************************************************************************/
+#pragma once
+
+#include "pong_core.h"
+#include "spatial_hash.h"
+#include <vector>
+#include <random>
+
+class PongChaos {
+public:
+    static constexpr int LANES = 4;                    // Balls per SIMD step
+    static constexpr float TICK_DT = PongCore::TICK_DT;
+    static constexpr float BALL_RADIUS = 5.0f;
+    static constexpr float MIN_SPEED = 150.0f;         // Serve speed range along x, pixels per second
+    static constexpr float MAX_SPEED = 450.0f;         // Cap on either axis
+    static constexpr float AI_SPEED = 450.0f;
+
+    static_assert(MAX_SPEED * TICK_DT * 1.5f < PongCore::PADDLE_WIDTH, "balls must not skip a paddle in one tick");
+    static_assert(MAX_SPEED * TICK_DT * 3.0f < 2.0f * BALL_RADIUS, "balls must not pass through each other in one tick");
+
+    explicit PongChaos(float fieldWidth = 1280.0f, float fieldHeight = 720.0f);
+
+    // Serves 'ballCount' balls from the middle in random directions; scores back to 0.
+    void Reset(int ballCount, unsigned seed);
+
+    // Ball-to-ball bounces (off by default; the broadphase is most of the cost when on).
+    void SetBallCollisions(bool enabled) { ballCollisions = enabled; }
+    bool GetBallCollisions() const { return ballCollisions; }
+
+    void Step(PongAction leftAction);
+
+    int GetBallCount() const { return ballCount; }
+    const PongBox& GetPaddle(PongCore::Side side) const { return paddles[side]; }
+    int GetScore(PongCore::Side side) const { return scores[side]; }
+    int GetLastContacts() const { return lastContacts; } // Ball-to-ball bounces in the last Step()
+
+    //----------------------------------------------------------------------------------
+    // Ball state, structure-of-arrays. Read freely; only Step()/Reset() write it. Sized
+    // to a multiple of LANES; entries from GetBallCount() on sit still mid-field, unused.
+    //----------------------------------------------------------------------------------
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> prevX, prevY;   // Positions at the previous tick, for interpolation
+
+private:
+    float fieldWidth, fieldHeight;
+    PongBox paddles[2];
+    int scores[2] = { 0, 0 };
+    int ballCount = 0;
+    bool ballCollisions = false;
+    int lastContacts = 0;
+    int aiBall = -1;            // Ball the AI paddle is going for
+    SpatialHash hash;
+    std::mt19937 rng;
+
+    void Serve(int ball);
+    void MovePaddles(PongAction leftAction);
+    void MoveBalls();
+    void CollideBalls();
+};
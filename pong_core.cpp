@@ -0,0 +1,97 @@
+/*******************************************************************************************
+*
+* pong_core.cpp - Headless Pong simulation (see pong_core.h)
+*
+********************************************************************************************/
+#include "pong_core.h"
+
+PongCore::PongCore(float width, float height) : fieldWidth(width), fieldHeight(height) {
+    Reset(1);
+}
+
+void PongCore::Reset(unsigned seed) {
+    rng.seed(seed);
+    float paddleY = fieldHeight / 2 - PADDLE_HEIGHT / 2;
+    paddles[LEFT] = { PADDLE_MARGIN, paddleY, PADDLE_WIDTH, PADDLE_HEIGHT };
+    paddles[RIGHT] = { fieldWidth - PADDLE_MARGIN - PADDLE_WIDTH, paddleY, PADDLE_WIDTH, PADDLE_HEIGHT };
+    ball = { { fieldWidth / 2, fieldHeight / 2 }, { INITIAL_BALL_SPEED, INITIAL_BALL_SPEED }, BALL_RADIUS };
+    scores[LEFT] = scores[RIGHT] = 0;
+    gameOver = false;
+    winner = LEFT;
+    tick = 0;
+    for (int side = 0; side < 2; side++) {
+        if (aiSettings[side]) ai[side].Reset(*aiSettings[side], (unsigned)rng());
+    }
+    NotifyAis();
+}
+
+void PongCore::Serve(Side side) {
+    ball.position = { fieldWidth / 2, fieldHeight / 2 };
+    ball.velocity.x = side == LEFT ? -INITIAL_BALL_SPEED : INITIAL_BALL_SPEED;
+    ball.velocity.y = INITIAL_BALL_SPEED * ((rng() & 1) == 0 ? -1 : 1);
+    NotifyAis();
+}
+
+void PongCore::SetAi(Side side, const PongAiSettings* settings) {
+    aiSettings[side] = settings;
+    if (!settings) return;
+    ai[side].Reset(*settings, (unsigned)rng());
+    ai[side].OnBallChanged(ball, FaceX(side), fieldHeight);
+}
+
+float PongCore::FaceX(Side side) const {
+    return side == LEFT ? paddles[LEFT].x + paddles[LEFT].width + ball.radius : paddles[RIGHT].x - ball.radius;
+}
+
+void PongCore::NotifyAis() {
+    for (int side = 0; side < 2; side++) {
+        if (aiSettings[side]) ai[side].OnBallChanged(ball, FaceX((Side)side), fieldHeight);
+    }
+}
+
+void PongCore::MovePaddle(Side side, PongAction action) {
+    PongBox& paddle = paddles[side];
+    if (aiSettings[side]) {
+        paddle.y = ai[side].Step(ball, paddle.y, paddle.height, fieldHeight, TICK_DT);
+        return;
+    }
+    if (action == PONG_ACTION_UP && paddle.y > 0) paddle.y -= PLAYER_SPEED * TICK_DT;
+    if (action == PONG_ACTION_DOWN && paddle.y < fieldHeight - paddle.height) paddle.y += PLAYER_SPEED * TICK_DT;
+}
+
+PongStepResult PongCore::Step(PongAction leftAction, PongAction rightAction) {
+    PongStepResult result;
+    if (gameOver) {
+        result.done = true;
+        return result;
+    }
+    tick++;
+
+    MovePaddle(LEFT, leftAction);
+    MovePaddle(RIGHT, rightAction);
+
+    // Move the ball, bouncing off walls and paddles anywhere along its path
+    int hits = MovePongBall(ball, paddles[LEFT], paddles[RIGHT], fieldHeight, TICK_DT);
+    if (hits & PONG_HIT_WALL) result.events |= PONG_EVENT_WALL;
+    if (hits & (PONG_HIT_LEFT | PONG_HIT_RIGHT)) {
+        result.events |= PONG_EVENT_PADDLE;
+        NotifyAis(); // Only a paddle hit changes where the ball will cross
+    }
+
+    // A point goes to the side the ball got past, and the ball is served towards the scorer
+    if (ball.position.x - ball.radius > fieldWidth) result.scorer = LEFT;
+    if (ball.position.x + ball.radius < 0) result.scorer = RIGHT;
+    if (result.scorer >= 0) {
+        Side scorer = (Side)result.scorer;
+        scores[scorer]++;
+        result.events |= PONG_EVENT_POINT;
+        Serve(scorer);
+        if (scores[scorer] >= WINNING_SCORE) {
+            gameOver = true;
+            winner = scorer;
+            result.events |= PONG_EVENT_GAME_OVER;
+            result.done = true;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************************
+*
+* pong_core.h - Headless Pong simulation
+*
+* The Pong rules with no raylib, window or input dependency, in fixed ticks. The PongChannel
+* in main.cpp feeds it the W/S keys and draws it; the batch runner (pong_batch.h) plays it
+* AI against AI. Each side's paddle is either driven by the action passed to Step() or by a
+* PongAi. Everything random comes from the seed given to Reset(), so the same seed and
+* actions always play out the same way:
+*
+*     PongCore game;
+*     game.Reset(seed);
+*     game.SetAi(PongCore::RIGHT, &PONG_AI_LEVELS[PONG_AI_NORMAL]);
+*     while (!game.IsGameOver()) {
+*         PongStepResult r = game.Step(PONG_ACTION_UP);
+*         // r.events, r.scorer, game.GetBall(), game.GetPaddle(PongCore::LEFT) ...
+*     }
+*
+********************************************************************************************/
+#pragma once
+
+#include "pong_physics.h"
+#include "pong_ai.h"
+#include <random>
+#include <cstdint>
+
+// ---------- Stepping API ----------
+enum PongAction { PONG_ACTION_NONE, PONG_ACTION_UP, PONG_ACTION_DOWN };
+
+enum PongEvent : unsigned {
+    PONG_EVENT_WALL      = 1 << 0,
+    PONG_EVENT_PADDLE    = 1 << 1,
+    PONG_EVENT_POINT     = 1 << 2,
+    PONG_EVENT_GAME_OVER = 1 << 3,
+};
+
+struct PongStepResult {
+    unsigned events = 0;  // PongEvent bits
+    int scorer = -1;      // PongCore::Side that won the point, or -1
+    bool done = false;    // Game over; call Reset() to play again
+};
+
+// ---------- PongCore ----------
+class PongCore {
+public:
+    enum Side { LEFT, RIGHT };
+
+    static constexpr float TICK_RATE = 240.0f;
+    static constexpr float TICK_DT = 1.0f / TICK_RATE;
+
+    static constexpr float PLAYER_SPEED = 500.0f;        // Pixels per second, action-driven paddles
+    static constexpr float INITIAL_BALL_SPEED = 350.0f;  // Along each axis
+    static constexpr float BALL_RADIUS = 8.0f;
+    static constexpr float PADDLE_WIDTH = 10.0f, PADDLE_HEIGHT = 100.0f, PADDLE_MARGIN = 30.0f;
+    static constexpr int WINNING_SCORE = 3;
+
+    explicit PongCore(float fieldWidth = 1280.0f, float fieldHeight = 720.0f);
+
+    // New game: paddles centred, scores 0, the ball served towards the right. Re-seeds the AIs.
+    void Reset(unsigned seed);
+
+    // Puts the ball back in the middle heading towards 'side', at a random vertical direction.
+    void Serve(Side side);
+
+    // nullptr hands the paddle back to Step()'s action. Keeps a pointer: 'settings' must
+    // outlive the core (PONG_AI_LEVELS entries do).
+    void SetAi(Side side, const PongAiSettings* settings);
+    const PongAiSettings* GetAi(Side side) const { return aiSettings[side]; }
+
+    // Advances one TICK_DT. The actions move action-driven paddles; AI paddles ignore them.
+    PongStepResult Step(PongAction leftAction, PongAction rightAction = PONG_ACTION_NONE);
+
+    // State
+    const PongBall& GetBall() const { return ball; }
+    const PongBox& GetPaddle(Side side) const { return paddles[side]; }
+    int GetScore(Side side) const { return scores[side]; }
+    bool IsGameOver() const { return gameOver; }
+    Side GetWinner() const { return winner; }
+    long GetTick() const { return tick; }
+    float GetFieldWidth() const { return fieldWidth; }
+    float GetFieldHeight() const { return fieldHeight; }
+
+private:
+    float fieldWidth, fieldHeight;
+    PongBox paddles[2];
+    PongBall ball;
+    int scores[2] = { 0, 0 };
+    bool gameOver = false;
+    Side winner = LEFT;
+    long tick = 0;
+
+    const PongAiSettings* aiSettings[2] = { nullptr, nullptr };
+    PongAi ai[2];
+    std::mt19937 rng;
+
+    // Where the ball's centre touches each paddle's face, for the AI prediction
+    float FaceX(Side side) const;
+    void MovePaddle(Side side, PongAction action);
+    void NotifyAis();
+};
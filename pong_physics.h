@@ -0,0 +1,173 @@
+/*******************************************************************************************
+*
+* pong_physics.h - Swept (continuous) collision for the Pong ball
+*
+* The ball speeds up by 10% on every paddle hit, so after a long rally it can travel further
+* than a paddle's width in one frame, and an overlap test at the end of the frame misses the
+* paddle. Here the ball is swept instead: each wall and paddle gives the exact time the ball
+* first touches it, the ball moves to the earliest one, bounces, and carries on with the time
+* that is left, so any number of bounces can happen in one frame:
+*
+*     PongBall ball = { { x, y }, { vx, vy }, radius };
+*     int events = MovePongBall(ball, leftPaddle, rightPaddle, fieldHeight, GetFrameTime());
+*
+* This holds at any speed and any frame time. The only limit is MAX_PONG_BOUNCES events per
+* call; time left after that is dropped, which stalls the ball for a moment but never lets
+* it through anything. Raylib-free, so the headless benchmarks can check it.
+*
+* PredictPongCrossing() gives where the ball will be when it reaches a given x, with all the
+* wall bounces on the way folded in closed form, for the AI (pong_ai.h).
+*
+********************************************************************************************/
+#pragma once
+
+#include <cmath>
+
+struct PongVec2 { float x, y; };
+struct PongBox { float x, y, width, height; };
+
+struct PongBall {
+    PongVec2 position;
+    PongVec2 velocity;   // Pixels per second
+    float radius;
+};
+
+// MovePongBall() result bits
+enum {
+    PONG_HIT_WALL = 1 << 0,
+    PONG_HIT_LEFT = 1 << 1,
+    PONG_HIT_RIGHT = 1 << 2,
+};
+
+static constexpr int MAX_PONG_BOUNCES = 64;
+static constexpr float PONG_PADDLE_SPEEDUP = 1.1f;
+
+inline bool CircleOverlapsBox(PongVec2 center, float radius, const PongBox& box) {
+    float closestX = std::fmin(std::fmax(center.x, box.x), box.x + box.width);
+    float closestY = std::fmin(std::fmax(center.y, box.y), box.y + box.height);
+    float dx = center.x - closestX, dy = center.y - closestY;
+    return dx * dx + dy * dy < radius * radius;
+}
+
+// Earliest time in [0, maxTime] at which a circle moving from 'position' at 'velocity' touches
+// 'box'; a circle that already overlaps it hits at 0. The centre's path is tested against the
+// box grown by 'radius' with rounded corners: the four sides pushed out, then the four corner
+// circles. Solved in double so huge velocities don't lose the root.
+inline bool SweepCircleBox(PongVec2 position, PongVec2 velocity, float radius, const PongBox& box,
+                           float maxTime, float& hitTime) {
+    if (CircleOverlapsBox(position, radius, box)) {
+        hitTime = 0.0f;
+        return true;
+    }
+
+    double best = maxTime;
+    bool hit = false;
+    double px = position.x, py = position.y, vx = velocity.x, vy = velocity.y, r = radius;
+    double left = box.x, top = box.y, right = box.x + box.width, bottom = box.y + box.height;
+
+    // Sides: only the one facing the motion on each axis, and only along its straight part
+    if (vx != 0.0) {
+        double t = ((vx > 0.0 ? left - r : right + r) - px) / vx;
+        double y = py + vy * t;
+        if (t >= 0.0 && t <= best && y >= top && y <= bottom) { best = t; hit = true; }
+    }
+    if (vy != 0.0) {
+        double t = ((vy > 0.0 ? top - r : bottom + r) - py) / vy;
+        double x = px + vx * t;
+        if (t >= 0.0 && t <= best && x >= left && x <= right) { best = t; hit = true; }
+    }
+
+    // Corners: first root of |p + v*t - corner| = r
+    double a = vx * vx + vy * vy;
+    if (a > 0.0) {
+        const double corners[4][2] = { { left, top }, { right, top }, { left, bottom }, { right, bottom } };
+        for (const auto& corner : corners) {
+            double dx = px - corner[0], dy = py - corner[1];
+            double b = dx * vx + dy * vy;
+            if (b >= 0.0) continue; // Moving away from this corner
+            double c = dx * dx + dy * dy - r * r;
+            double discriminant = b * b - a * c;
+            if (discriminant < 0.0) continue;
+            double t = (-b - std::sqrt(discriminant)) / a;
+            if (t >= 0.0 && t <= best) { best = t; hit = true; }
+        }
+    }
+
+    if (hit) hitTime = (float)best;
+    return hit;
+}
+
+// Pong's paddle rule: back the other way 10% faster, with the vertical speed set by where on
+// the paddle the ball hit (centre = straight, ends = 45 degrees).
+inline void BouncePongBall(PongBall& ball, const PongBox& paddle) {
+    ball.velocity.x *= -PONG_PADDLE_SPEEDUP;
+    float halfHeight = paddle.height / 2;
+    ball.velocity.y = (ball.position.y - (paddle.y + halfHeight)) / halfHeight * std::fabs(ball.velocity.x);
+}
+
+// Advances the ball by 'deltaTime' seconds between the top and bottom walls (y = 0 and
+// y = fieldHeight) and the two paddles, which hold still meanwhile. A paddle is only hit
+// while the ball is heading towards the opponent's side of it, as in the discrete version.
+// Returns PONG_HIT_* bits for everything hit.
+inline int MovePongBall(PongBall& ball, const PongBox& leftPaddle, const PongBox& rightPaddle,
+                        float fieldHeight, float deltaTime) {
+    int events = 0;
+    float remaining = deltaTime;
+    for (int bounce = 0; bounce < MAX_PONG_BOUNCES && remaining > 0.0f; bounce++) {
+        float time = remaining, hitTime;
+        int event = 0;
+
+        if (ball.velocity.y < 0.0f) {
+            float t = std::fmax(0.0f, (ball.radius - ball.position.y) / ball.velocity.y);
+            if (t <= time) { time = t; event = PONG_HIT_WALL; }
+        } else if (ball.velocity.y > 0.0f) {
+            float t = std::fmax(0.0f, (fieldHeight - ball.radius - ball.position.y) / ball.velocity.y);
+            if (t <= time) { time = t; event = PONG_HIT_WALL; }
+        }
+        // Most of the time the ball can't get within reach of a paddle this step at all
+        float reachX = ball.position.x + ball.velocity.x * time;
+        if (ball.velocity.x < 0.0f && reachX - ball.radius <= leftPaddle.x + leftPaddle.width &&
+            SweepCircleBox(ball.position, ball.velocity, ball.radius, leftPaddle, time, hitTime)) {
+            time = hitTime;
+            event = PONG_HIT_LEFT;
+        }
+        if (ball.velocity.x > 0.0f && reachX + ball.radius >= rightPaddle.x &&
+            SweepCircleBox(ball.position, ball.velocity, ball.radius, rightPaddle, time, hitTime)) {
+            time = hitTime;
+            event = PONG_HIT_RIGHT;
+        }
+
+        ball.position.x += ball.velocity.x * time;
+        ball.position.y += ball.velocity.y * time;
+        remaining -= time;
+        if (event == 0) break;
+
+        events |= event;
+        if (event == PONG_HIT_WALL) ball.velocity.y = -ball.velocity.y;
+        else BouncePongBall(ball, event == PONG_HIT_LEFT ? leftPaddle : rightPaddle);
+    }
+    return events;
+}
+
+// Where the ball's centre will be when it reaches x = 'targetX', bouncing off the walls on
+// the way, and how many seconds that takes. Between the walls the centre moves in
+// [radius, fieldHeight - radius], so its unbounced path is folded back into that range: a
+// triangle wave with period twice the range. False if the ball is moving away from 'targetX'.
+inline bool PredictPongCrossing(const PongBall& ball, float targetX, float fieldHeight, float& crossingY, float& crossingTime) {
+    double distance = (double)targetX - ball.position.x;
+    if (ball.velocity.x == 0.0f || (distance > 0.0) != (ball.velocity.x > 0.0f)) return false;
+    double time = distance / ball.velocity.x;
+
+    double range = (double)fieldHeight - 2.0 * ball.radius;
+    double y = ball.position.y + ball.velocity.y * time - ball.radius;
+    if (range > 0.0) {
+        y = std::fmod(y, 2.0 * range);
+        if (y < 0.0) y += 2.0 * range;
+        if (y > range) y = 2.0 * range - y;
+    } else {
+        y = 0.0;
+    }
+    crossingY = (float)(y + ball.radius);
+    crossingTime = (float)time;
+    return true;
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************************
+*
+* pong_tune - Win rates of Pong AI parameter sets, from seeded rallies played headless
+*
+*   g++ -O2 -std=c++17 pong_tune.cpp pong_core.cpp pong_batch.cpp -o pong_tune -pthread
+*   ./pong_tune [rallies] [opponent] [threads]
+*
+* Plays 'rallies' rallies (default 20000) of every preset in pong_ai.h and of a grid of
+* paddle speeds, reaction delays and aim errors against one opponent preset (default
+* Chase), on every core, and prints each set's share of rallies won with a 95% interval.
+* The same seed is used every run, so a change to the rules shows up as a change here.
+*
+********************************************************************************************/
+#include "pong_batch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+int main(int argc, char** argv) {
+    int rallies = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const char* opponentName = argc > 2 ? argv[2] : "Chase";
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    const PongAiSettings* opponent = nullptr;
+    for (const PongAiSettings& level : PONG_AI_LEVELS) {
+        if (strcmp(level.name, opponentName) == 0) opponent = &level;
+    }
+    std::vector<PongAiSettings> candidates(std::begin(PONG_AI_LEVELS), std::end(PONG_AI_LEVELS));
+    for (float speed : { 300.0f, 350.0f, 450.0f })
+        for (float delay : { 0.0f, 0.15f, 0.3f })
+            for (float error : { 0.0f, 30.0f, 60.0f })
+                candidates.push_back({ "grid", true, speed, delay, error });
+
+    if (rallies <= 0 || rallies > PongBatch::MaxRallies(candidates.size()) || !opponent) {
+        printf("usage: pong_tune [rallies] [Chase|Easy|Normal|Hard] [threads]\n");
+        printf("  rallies: 1 to %d (%d parameter sets)\n", PongBatch::MaxRallies(candidates.size()), (int)candidates.size());
+        return 1;
+    }
+
+    PongBatch batch(threads);
+    printf("pong_tune: %d rallies per set against %s, %d threads\n", rallies, opponent->name, batch.GetThreadCount());
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PongRallyStats> stats = batch.PlayRallies(candidates, *opponent, rallies, 7);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("  %-7s %6s %6s %6s   %7s  %7s  %9s  %s\n", "set", "speed", "delay", "error", "win", "+-95%", "hits", "unfinished");
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const PongAiSettings& c = candidates[i];
+        const PongRallyStats& s = stats[i];
+        double p = s.WinRate(), interval = 1.96 * std::sqrt(p * (1.0 - p) / (double)s.rallies);
+        printf("  %-7s %6.0f %6.2f %6.0f   %6.1f%%  %6.1f%%  %9.1f  %lld\n", c.predict ? c.name : "Chase", c.paddleSpeed,
+               c.reactionDelay, c.aimError, p * 100.0, interval * 100.0, s.AverageHits(), s.unfinished);
+    }
+    long long total = (long long)rallies * (long long)candidates.size();
+    printf("  %lld rallies in %.1f s (%.0f rallies/s)\n", total, seconds, total / seconds);
+    return 0;
+}
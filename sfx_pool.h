@@ -0,0 +1,149 @@
+/*******************************************************************************************
+*
+* sfx_pool.h - Fixed pools of voices for short, frequently triggered sound effects
+*
+* PlaySound() on a single Sound restarts it from the beginning, which clicks when a pellet
+* is eaten every few ticks. SfxPool loads each effect once and makes VOICES_PER_SOUND (at
+* most MAX_VOICES) aliases of it with LoadSoundAlias(), which share the sample data but
+* play independently:
+*
+*     SfxPool sfx;
+*     int chomp = sfx.Load("assets/chomp.wav", 4, 0.05f);  // 4 voices, at most one per 50 ms
+*     ...
+*     sfx.Play(chomp);                                      // game thread, any number of times
+*
+* Play() uses a free voice, or stops and reuses the one that started longest ago. Triggers
+* that come sooner than the sound's minimum interval after the last one are dropped, so a
+* burst of events (several ticks caught up in one frame, a ghost swarm) costs one voice.
+* Voices are tracked by the time they will finish (the length comes from Load()), so
+* picking a voice and the statistics never query raylib. Everything is allocated in
+* Load(); Play() does not allocate, but PlaySound() and StopSound() still take raylib's
+* audio lock for a moment, so it costs one lock per accepted trigger (two when stealing).
+*
+********************************************************************************************/
+#pragma once
+
+#include "raylib.h"
+
+class SfxPool {
+public:
+    static constexpr int MAX_SOUNDS = 8;
+    static constexpr int MAX_VOICES = 8;
+
+    SfxPool() = default;
+    ~SfxPool() { Unload(); }
+    SfxPool(const SfxPool&) = delete;
+    SfxPool& operator=(const SfxPool&) = delete;
+
+    // Returns the id to Play(), or -1 if the pool is full. The file failing to load still
+    // returns an id; playing it is silent, like raylib.
+    int Load(const char* fileName, int voices, float minInterval) {
+        if (soundCount >= MAX_SOUNDS) return -1;
+        Entry& entry = sounds[soundCount];
+        entry.source = LoadSound(fileName);
+        entry.voiceCount = voices < 1 ? 1 : (voices > MAX_VOICES ? MAX_VOICES : voices);
+        entry.voices[0] = entry.source;
+        for (int v = 1; v < entry.voiceCount; v++) entry.voices[v] = LoadSoundAlias(entry.source);
+        unsigned int sampleRate = entry.source.stream.sampleRate;
+        entry.length = sampleRate > 0 ? (double)entry.source.frameCount/sampleRate : 0.0;
+        entry.minInterval = minInterval;
+        entry.lastTrigger = -1e9;
+        return soundCount++;
+    }
+
+    void Unload() {
+        for (int i = 0; i < soundCount; i++) {
+            Entry& entry = sounds[i];
+            for (int v = 1; v < entry.voiceCount; v++) UnloadSoundAlias(entry.voices[v]);
+            UnloadSound(entry.source);
+            entry = Entry();
+        }
+        soundCount = 0;
+    }
+
+    // Returns false if the trigger was dropped by the rate limit.
+    bool Play(int id) {
+        if (id < 0 || id >= soundCount) return false;
+        Entry& entry = sounds[id];
+        double now = GetTime();
+        if (now - entry.lastTrigger < entry.minInterval) {
+            droppedTriggers++;
+            return false;
+        }
+        entry.lastTrigger = now;
+
+        int voice = -1, oldest = 0;
+        for (int v = 0; v < entry.voiceCount; v++) {
+            if (entry.endTime[v] <= now) {
+                voice = v;
+                break;
+            }
+            if (entry.endTime[v] < entry.endTime[oldest]) oldest = v;
+        }
+        if (voice < 0) {
+            voice = oldest;
+            StopSound(entry.voices[voice]);
+            stolenVoices++;
+        }
+        entry.endTime[voice] = now + entry.length;
+        PlaySound(entry.voices[voice]);
+        return true;
+    }
+
+    void Stop(int id) {
+        if (id < 0 || id >= soundCount) return;
+        Entry& entry = sounds[id];
+        double now = GetTime();
+        for (int v = 0; v < entry.voiceCount; v++) {
+            if (entry.endTime[v] <= now) continue;
+            StopSound(entry.voices[v]);
+            entry.endTime[v] = 0.0;
+        }
+    }
+
+    bool IsPlaying(int id) const {
+        if (id < 0 || id >= soundCount) return false;
+        double now = GetTime();
+        for (int v = 0; v < sounds[id].voiceCount; v++) {
+            if (sounds[id].endTime[v] > now) return true;
+        }
+        return false;
+    }
+
+    void SetVolume(int id, float volume) {
+        if (id < 0 || id >= soundCount) return;
+        for (int v = 0; v < sounds[id].voiceCount; v++) SetSoundVolume(sounds[id].voices[v], volume);
+    }
+
+    // Statistics
+    int GetActiveVoices() const {
+        int active = 0;
+        double now = GetTime();
+        for (int i = 0; i < soundCount; i++) {
+            for (int v = 0; v < sounds[i].voiceCount; v++) active += sounds[i].endTime[v] > now ? 1 : 0;
+        }
+        return active;
+    }
+    int GetVoiceCount() const {
+        int total = 0;
+        for (int i = 0; i < soundCount; i++) total += sounds[i].voiceCount;
+        return total;
+    }
+    long long GetDroppedTriggers() const { return droppedTriggers; }
+    long long GetStolenVoices() const { return stolenVoices; }
+
+private:
+    struct Entry {
+        Sound source = {};
+        Sound voices[MAX_VOICES] = {};    // voices[0] is the source itself
+        double endTime[MAX_VOICES] = {};  // GetTime() when each voice finishes
+        int voiceCount = 0;
+        double length = 0.0;              // Seconds, frameCount/sampleRate
+        float minInterval = 0.0f;
+        double lastTrigger = -1e9;
+    };
+
+    Entry sounds[MAX_SOUNDS];
+    int soundCount = 0;
+    long long droppedTriggers = 0, stolenVoices = 0;
+};
@@ -0,0 +1,94 @@
+/*******************************************************************************************
+*
+* spatial_hash.h - Uniform-grid spatial hash for many small moving objects
+*
+* Positions are binned into square cells, and cells are hashed into a power-of-two bucket
+* table, so memory scales with the object count and not with the size of the world. Each
+* bucket is an intrusive linked list, so moving an object to another cell is O(1) and moves
+* within a cell cost nothing:
+*
+*     hash.Reset(count, cellSize);
+*     for (int i = 0; i < count; i++) hash.Update(i, x[i], y[i]);   // again whenever i moves
+*     hash.Query(minX, minY, maxX, maxY, [&](int i) { ... });
+*
+* Query() reports every object whose last Update() position lies in a cell overlapping the
+* box, each once. It can also report objects from other cells that share a bucket, so
+* callers still run their exact overlap test. Report order is unspecified.
+*
+********************************************************************************************/
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+class SpatialHash {
+public:
+    void Reset(int count, float newCellSize) {
+        inverseCellSize = 1.0f / newCellSize;
+
+        int buckets = 16;
+        while (buckets < count * 2) buckets <<= 1;
+        bucketMask = (uint32_t)buckets - 1;
+
+        bucketHead.assign(buckets, -1);
+        next.assign(count, -1);
+        prev.assign(count, -1);
+        itemBucket.assign(count, NONE);
+    }
+
+    void Update(int item, float x, float y) {
+        uint32_t bucket = Bucket(Cell(x), Cell(y));
+        if (bucket == itemBucket[item]) return;
+        if (itemBucket[item] != NONE) Unlink(item);
+
+        itemBucket[item] = bucket;
+        prev[item] = -1;
+        next[item] = bucketHead[bucket];
+        if (next[item] >= 0) prev[next[item]] = item;
+        bucketHead[bucket] = item;
+    }
+
+    template <typename VisitFn>
+    void Query(float minX, float minY, float maxX, float maxY, VisitFn visit) const {
+        int cellX0 = Cell(minX), cellY0 = Cell(minY), cellX1 = Cell(maxX), cellY1 = Cell(maxY);
+
+        // A small box touches a handful of cells; skip buckets two of them hash to
+        uint32_t visited[16];
+        int visitedCount = 0;
+        for (int cy = cellY0; cy <= cellY1; cy++) {
+            for (int cx = cellX0; cx <= cellX1; cx++) {
+                uint32_t bucket = Bucket(cx, cy);
+                bool seen = false;
+                for (int v = 0; v < visitedCount; v++) seen |= visited[v] == bucket;
+                if (seen) continue;
+                if (visitedCount < 16) visited[visitedCount++] = bucket;
+
+                for (int i = bucketHead[bucket]; i >= 0; i = next[i]) visit(i);
+            }
+        }
+    }
+
+    int GetBucketCount() const { return (int)bucketMask + 1; }
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    float inverseCellSize = 1.0f;
+    uint32_t bucketMask = 0;
+    std::vector<int> bucketHead;       // First item in each bucket, -1 if empty
+    std::vector<int> next, prev;       // Per-item links within its bucket
+    std::vector<uint32_t> itemBucket;  // NONE until the item's first Update()
+
+    int Cell(float v) const { return (int)std::floor(v * inverseCellSize); }
+
+    uint32_t Bucket(int cx, int cy) const {
+        return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & bucketMask;
+    }
+
+    void Unlink(int item) {
+        if (prev[item] >= 0) next[prev[item]] = next[item];
+        else bucketHead[itemBucket[item]] = next[item];
+        if (next[item] >= 0) prev[next[item]] = prev[item];
+    }
+};
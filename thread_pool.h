@@ -0,0 +1,117 @@
+/*******************************************************************************************
+*
+* thread_pool.h - Minimal persistent worker pool
+*
+* ParallelFor(count, fn) splits [0, count) into contiguous chunks and runs fn(begin, end)
+* on every worker plus the calling thread, returning when all chunks are done. Workers
+* sleep between calls, so a pool can be kept around and called every frame.
+*
+* Web builds without pthreads (or a pool created with one thread) just run inline.
+*
+********************************************************************************************/
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define THREAD_POOL_INLINE_ONLY
+#endif
+
+class ThreadPool {
+public:
+    // threadCount includes the calling thread; 0 means one per hardware thread.
+    explicit ThreadPool(int threadCount = 0) {
+#ifdef THREAD_POOL_INLINE_ONLY
+        threadCount = 1;
+#else
+        if (threadCount <= 0) threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+#endif
+        for (int i = 1; i < threadCount; i++) workers.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const { return (int)workers.size() + 1; }
+
+    void ParallelFor(int count, const std::function<void(int, int)>& fn, int minChunk = 1) {
+        if (count <= 0) return;
+        int chunks = std::min(GetThreadCount() * 4, std::max(1, count / std::max(1, minChunk)));
+        if (chunks <= 1 || workers.empty()) {
+            fn(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobChunks = chunks;
+            nextChunk = 0;
+            workersFinished = 0;
+            generation++;
+        }
+        wake.notify_all();
+
+        RunChunks();
+
+        // Every worker checks in once per call, so none can still be inside RunChunks()
+        // when the next call resets the counters.
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return workersFinished == (int)workers.size(); });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    bool stopping = false;
+    unsigned generation = 0;
+
+    const std::function<void(int, int)>* job = nullptr;
+    int jobCount = 0, jobChunks = 0;
+    std::atomic<int> nextChunk{0};
+    int workersFinished = 0;
+
+    void RunChunks() {
+        for (int chunk = nextChunk++; chunk < jobChunks; chunk = nextChunk++) {
+            int begin = (int)((long long)jobCount * chunk / jobChunks);
+            int end = (int)((long long)jobCount * (chunk + 1) / jobChunks);
+            (*job)(begin, end);
+        }
+    }
+
+    void WorkerLoop() {
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            RunChunks();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                workersFinished++;
+            }
+            done.notify_one();
+        }
+    }
+};
@@ -0,0 +1,79 @@
+/*******************************************************************************************
+*
+* transposition_table.h - Fixed-size, lock-free hash table for search results
+*
+* Maps a 64-bit state hash (e.g. PacmanCore::GetZobristHash()) to 64 bits of caller data.
+* Any number of threads may Probe() and Store() at once without locks. Each slot holds the
+* data and key ^ data as two relaxed atomics, so a read that races a write sees a key that
+* doesn't match and simply misses instead of returning half of another entry:
+*
+*     TranspositionTable table;
+*     table.Resize(1 << 20);
+*     uint64_t data;
+*     if (table.Probe(hash, data)) ...    // reuse
+*     else table.Store(hash, Search());
+*
+* Slots are direct-mapped and always replaced, so the table never grows and old entries are
+* simply overwritten. Data 0 is reserved for empty slots; set a bit that is always 1.
+*
+********************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+class TranspositionTable {
+public:
+    // Rounds entryCount up to a power of two and empties the table; 0 frees it, after which
+    // every Probe() misses. Not thread-safe.
+    void Resize(size_t entryCount) {
+        if (entryCount == 0) {
+            slots.reset();
+            mask = 0;
+            return;
+        }
+        size_t size = 1;
+        while (size < entryCount) size <<= 1;
+        slots.reset(new Slot[size]);
+        mask = size - 1;
+        Clear();
+    }
+
+    // Not thread-safe.
+    void Clear() {
+        for (size_t i = 0; i <= mask && slots; i++) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool Probe(uint64_t key, uint64_t& data) const {
+        if (!slots) return false;
+        const Slot& slot = slots[key & mask];
+        uint64_t value = slot.data.load(std::memory_order_relaxed);
+        if (value == 0 || (slot.check.load(std::memory_order_relaxed) ^ value) != key) return false;
+        data = value;
+        return true;
+    }
+
+    void Store(uint64_t key, uint64_t data) {
+        if (!slots) return;
+        Slot& slot = slots[key & mask];
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    size_t GetEntryCount() const { return slots ? mask + 1 : 0; }
+    size_t MemoryBytes() const { return GetEntryCount() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};  // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+};